@@ -0,0 +1,40 @@
+#ifndef AUDIO_ENGINE_H
+#define AUDIO_ENGINE_H
+
+#include <Arduino.h>
+#include "christmas_songs.h"
+
+// Timer-driven song player.
+// loop() only decodes notes into a lock-free queue; an esp_timer callback plays
+// them. Every onset is computed from the start of the song, so a slow web request
+// or LED frame can delay filling the queue but never shifts the timing of a note.
+
+// Notes decoded ahead of playback (power of two)
+#define AUDIO_QUEUE_LENGTH 32
+
+// How often loop() has to top up the queue; 32 notes last well over a second
+const uint32_t AUDIO_REFILL_INTERVAL = 250;
+
+struct AudioStats {
+  uint32_t notesPlayed;
+  uint32_t underruns;      // a note was due but not decoded yet
+  uint32_t maxLatenessUs;  // worst delay between scheduled and actual onset
+};
+
+void audioBegin(uint8_t buzzerPin);
+void audioStart(const Song& song);
+void audioStop();
+
+// Percent of each note the buzzer sounds, for notes decoded from now on;
+// shorter notes save battery (0 is taken as 1%)
+void audioSetDuty(uint8_t percent);
+
+// Decodes notes until the queue is full (call from loop())
+void audioFill();
+
+// True once the last note of the song has been played
+bool audioFinished();
+
+const AudioStats& audioStats();
+
+#endif // AUDIO_ENGINE_H
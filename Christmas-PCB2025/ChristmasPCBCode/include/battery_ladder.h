@@ -0,0 +1,54 @@
+#ifndef BATTERY_LADDER_H
+#define BATTERY_LADDER_H
+
+#include <Arduino.h>
+
+// Low-battery degradation ladder.
+// As the filtered sense voltage falls, the board gives up what costs the most
+// charge first and keeps a glow going as long as it can: slower animation and
+// lower brightness, shorter notes, no WiFi, then only a dim glow, and at the
+// bottom deep sleep until a button is pressed. A step is taken down as soon as
+// the voltage drops below its threshold, but only back up once the voltage is
+// LADDER_HYSTERESIS_MV above it again, so cells that recover a little when the
+// load drops don't make the board flap between steps.
+
+enum BatteryLevel : uint8_t {
+  BATTERY_OK,
+  BATTERY_SAVE,
+  BATTERY_LOW,
+  BATTERY_GLOW,
+  BATTERY_EMPTY,
+  NUM_BATTERY_LEVELS
+};
+
+// Thresholds, in mV on the sense pin (see the curve in fuel_gauge.cpp)
+const uint16_t LADDER_SAVE_MV = 2000;   // ~22% left
+const uint16_t LADDER_LOW_MV = 1850;    // ~10%
+const uint16_t LADDER_GLOW_MV = 1700;   // ~4%
+const uint16_t LADDER_EMPTY_MV = 1550;  // ~1%
+const uint16_t LADDER_HYSTERESIS_MV = 100;
+
+struct BatteryStep {
+  const char* name;
+  uint16_t belowMv;       // taken when the voltage drops below this
+  uint8_t maxBrightness;
+  uint8_t frameSlowdown;  // pattern step intervals are this many times longer
+  uint8_t songDuty;       // percent of each note the buzzer sounds; 0: no songs
+  bool wifi;
+};
+
+// Starts at BATTERY_OK; the first reading takes the ladder straight to its step
+void ladderBegin();
+
+// Steps down or up for a new reading; each change is logged. USB power is
+// always BATTERY_OK.
+BatteryLevel ladderUpdate(bool onBattery, uint16_t millivolts);
+
+BatteryLevel ladderLevel();
+
+const BatteryStep& ladderStep();
+
+// Current step and how often the ladder has moved
+void ladderPrintStats();
+
+#endif // BATTERY_LADDER_H
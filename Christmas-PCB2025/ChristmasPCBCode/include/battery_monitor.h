@@ -0,0 +1,39 @@
+#ifndef BATTERY_MONITOR_H
+#define BATTERY_MONITOR_H
+
+#include <Arduino.h>
+
+// Voltage on the battery sense pin.
+// A measurement is a burst of BATTERY_OVERSAMPLE calibrated conversions
+// (analogReadMilliVolts() applies the eFuse ADC calibration) whose mean goes
+// through an IIR filter, so batteryMillivolts() is a stable value that costs
+// nothing to poll. The caller takes bursts while the LEDs are dark (the strip's
+// current sags the cells) and the buzzer is quiet; a jump of more than
+// BATTERY_STEP_MV is a change of power source, not noise, and restarts the
+// filter so USB/battery switches are seen at once.
+
+const uint8_t BATTERY_OVERSAMPLE = 16;
+const uint8_t BATTERY_SEED_SAMPLES = 64;  // first measurement, before the filter has history
+const uint8_t BATTERY_IIR_SHIFT = 2;      // each burst moves the reading 1/4 of the way
+const uint16_t BATTERY_STEP_MV = 300;
+
+struct BatteryStats {
+  uint32_t bursts;
+  uint32_t resets;     // source changes seen as a step
+  uint16_t lastBurstMv;
+  uint16_t minMv;      // filtered reading
+  uint16_t maxMv;
+};
+
+// Seeds the filter from a long burst
+void batteryBegin(uint8_t pin);
+
+// Takes one burst and updates the filtered reading
+void batterySample();
+
+// Filtered voltage on the sense pin
+uint16_t batteryMillivolts();
+
+const BatteryStats& batteryStats();
+
+#endif // BATTERY_MONITOR_H
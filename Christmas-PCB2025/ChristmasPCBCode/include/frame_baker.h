@@ -0,0 +1,74 @@
+#ifndef FRAME_BAKER_H
+#define FRAME_BAKER_H
+
+#include <Arduino.h>
+
+// Compile-time animation baking.
+// A periodic pattern is written once as a constexpr "frame k of the cycle"
+// function; bakeFrames() runs it for every k at compile time and the result
+// lands in flash. Playback is then a 3*NUM_LEDS byte copy per step.
+// The 8-bit math mirrors FastLED (sin8, nscale8 with FASTLED_SCALE8_FIXED) so
+// baked frames are bit-identical to what the runtime versions drew.
+
+template <uint16_t Frames, uint16_t Leds>
+struct BakedAnimation {
+  uint8_t rgb[Frames][Leds][3];
+
+  constexpr uint16_t frameCount() const { return Frames; }
+};
+
+typedef uint32_t BakedColor;  // 0xRRGGBB, same as CRGB::HTMLColorCode
+
+namespace baker {
+
+constexpr uint8_t scale8(uint8_t value, uint8_t scale) {
+  return ((uint16_t)value * (1 + (uint16_t)scale)) >> 8;
+}
+
+// FastLED's portable sin8_C()
+constexpr uint8_t sin8(uint8_t theta) {
+  const uint8_t interleave[] = { 0, 49, 49, 41, 90, 27, 117, 10 };
+  uint8_t offset = theta;
+  if (theta & 0x40) {
+    offset = (uint8_t)255 - offset;
+  }
+  offset &= 0x3F;
+
+  uint8_t secoffset = offset & 0x0F;
+  if (theta & 0x40) ++secoffset;
+
+  uint8_t section = offset >> 4;
+  uint8_t b = interleave[section * 2];
+  uint8_t m16 = interleave[section * 2 + 1];
+  uint8_t mx = (m16 * secoffset) >> 4;
+
+  int8_t y = mx + b;
+  if (theta & 0x80) y = -y;
+  y += 128;
+  return y;
+}
+
+// leds[led] = color; leds[led].nscale8(scale) (scale 255 leaves the color as is)
+template <uint16_t Leds>
+constexpr void setPixel(uint8_t (&frame)[Leds][3], int led, BakedColor color, uint8_t scale = 255) {
+  frame[led][0] = scale8((color >> 16) & 0xFF, scale);
+  frame[led][1] = scale8((color >> 8) & 0xFF, scale);
+  frame[led][2] = scale8(color & 0xFF, scale);
+}
+
+} // namespace baker
+
+// Draws step 'k' (0 = first step after the pattern starts) into a black frame
+template <uint16_t Leds>
+using FrameFunction = void (*)(uint16_t k, uint8_t (&frame)[Leds][3]);
+
+template <uint16_t Frames, uint16_t Leds>
+constexpr BakedAnimation<Frames, Leds> bakeFrames(FrameFunction<Leds> draw) {
+  BakedAnimation<Frames, Leds> animation = {};
+  for (uint16_t k = 0; k < Frames; k++) {
+    draw(k, animation.rgb[k]);
+  }
+  return animation;
+}
+
+#endif // FRAME_BAKER_H
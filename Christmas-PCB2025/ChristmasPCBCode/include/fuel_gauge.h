@@ -0,0 +1,57 @@
+#ifndef FUEL_GAUGE_H
+#define FUEL_GAUGE_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+// Battery fuel gauge.
+// Counts the charge drawn from the batteries with a model of the board's
+// current: the chip (the clock model in power_manager), the LEDs (every frame
+// sent to the strip, at its brightness, plus the WS2812s' idle current, which
+// flows even in deep sleep), the WiFi AP and the buzzer. The count is pulled
+// slowly toward the state of charge read off a 2xAAA alkaline discharge curve,
+// which corrects the model's drift, and jumps to it when the voltage says the
+// batteries were replaced. The consumed charge survives resets and deep sleep
+// in RTC memory (the sleep is charged at the deep sleep current) and power loss
+// in the settings blob, in FUEL_SAVE_STEP_MAH steps. The same model sets the
+// LED power budget: fuelLimitBrightness() dims a frame whose peak supply
+// current would be too high.
+
+const uint16_t FUEL_CAPACITY_MAH = 1000;  // 2x AAA alkaline in series, at tens of mA
+const uint16_t FUEL_SAVE_STEP_MAH = 10;
+
+// Seeds the gauge from RTC memory, or after a power loss from the consumed
+// charge saved in the settings
+void fuelBegin(uint16_t savedMah);
+
+// Call with every frame sent to the strip; it draws until the next one
+void fuelFrame(const CRGB* leds, uint16_t count, uint8_t brightness);
+
+// Call with every battery measurement: counts the charge since the last call
+// (on batteries only; wifi and buzzer are taken as on or off for the whole
+// interval) and checks the count against the voltage
+void fuelUpdate(bool onBattery, bool wifi, bool buzzer, uint16_t millivolts);
+
+// Peak current of the board without the strip: the chip, WiFi TX bursts and
+// the buzzer, for the LED power budget
+uint32_t fuelPeakMicroamps(bool wifi, bool buzzer);
+
+// Highest brightness, up to the one given, at which the strip showing leds[]
+// keeps the supply current within budgetMicroamps while the rest of the board
+// draws otherMicroamps
+uint8_t fuelLimitBrightness(const CRGB* leds, uint16_t count, uint8_t brightness,
+                            uint32_t otherMicroamps, uint32_t budgetMicroamps);
+
+uint16_t fuelConsumedMah();
+
+// Charge left, by the count
+uint8_t fuelPercent();
+
+// Runtime left at the recent draw (whatever is running now); 0 if not known yet
+uint32_t fuelMinutesRemaining();
+
+// Charge left, the draw, the runtime at it and, from the draw of the lit
+// patterns seen so far, the days on a timer with onSeconds lit per cycleSeconds
+void fuelPrintStats(uint32_t onSeconds, uint32_t cycleSeconds);
+
+#endif // FUEL_GAUGE_H
@@ -0,0 +1,108 @@
+#ifndef PATTERNS_H
+#define PATTERNS_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+// LED patterns.
+// Every pattern is one row in the patterns[] registry: how to start it, how to
+// advance it one step and how often. All patterns share one state arena (a union),
+// so RAM only holds the state of the pattern that is running.
+
+#define NUM_LEDS 8
+
+enum DisplayMode {
+  STATIC_COLOR,
+  RANDOM_SCATTER,
+  RAINBOW_MODE,
+  SNAKE_MODE,
+  RANDOM_BLINK,
+  CHASE_MODE,
+  WAVE_MODE,
+  FADE_RANDOM,
+  SPARKLE_MODE,
+  FIREWORK_MODE,
+  METEOR_MODE,
+  CANDY_CANE_MODE,
+  OFF_MODE,
+  NUM_DISPLAY_MODES
+};
+
+// Per-pattern state
+struct BakedState {
+  uint16_t frame;  // next frame of the baked cycle
+};
+
+struct BlinkState {
+  uint8_t leds[3];
+};
+
+struct FadeState {
+  uint8_t progress;
+  bool needNewTarget;
+  CRGB current[NUM_LEDS];
+  CRGB target[NUM_LEDS];
+};
+
+struct SparkleState {
+  uint8_t brightness[NUM_LEDS];
+  uint8_t colors[NUM_LEDS];
+};
+
+struct FireworkState {
+  int8_t position;
+  uint8_t phase;
+  uint8_t brightness;
+  bool isRed;
+};
+
+struct MeteorState {
+  int8_t pos;
+  uint8_t tail[3];
+  bool isRed;
+};
+
+struct SolidState {
+  CRGB color;
+};
+
+union PatternState {
+  PatternState() {}  // CRGB members have constructors; init() sets up the active one
+
+  BakedState baked;
+  BlinkState blink;
+  FadeState fade;
+  SparkleState sparkle;
+  FireworkState firework;
+  MeteorState meteor;
+  SolidState solid;
+};
+
+// init() starts a pattern on a cleared frame; color is the static color choice.
+// step() advances it and returns true if leds[] changed.
+typedef void (*PatternInit)(PatternState& state, CRGB* leds, const CRGB& color);
+typedef bool (*PatternStep)(PatternState& state, CRGB* leds);
+
+struct Pattern {
+  const char* name;
+  const char* label;   // shown in the web portal
+  PatternInit init;
+  PatternStep step;
+  uint16_t interval;   // ms between steps
+  uint16_t stateSize;  // bytes of the arena this pattern uses
+};
+
+extern const Pattern patterns[NUM_DISPLAY_MODES];
+
+// The arena shared by all patterns
+extern PatternState patternState;
+
+// Starts 'mode' from a black frame
+void beginPattern(DisplayMode mode, CRGB* leds, const CRGB& color);
+
+// Advances 'mode' one step; true if leds[] changed
+inline bool stepPattern(DisplayMode mode, CRGB* leds) {
+  return patterns[mode].step(patternState, leds);
+}
+
+#endif // PATTERNS_H
@@ -0,0 +1,60 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+
+// CPU clock scaling.
+// The CPU runs at the lowest clock that no subsystem objects to. Each subsystem
+// holds its lock only while it needs the speed: the AP, a song, an animation,
+// a frame going out to the strip. Where the IDF build has power management
+// (CONFIG_PM_ENABLE) the locks are esp_pm locks and the driver scales the
+// clock; otherwise the module sets it with setCpuFrequencyMhz(). Idle time is
+// light sleep either way, from idleUntil() in main.cpp, which knows the
+// wake-up sources.
+
+enum PowerLock : uint8_t {
+  POWER_LOCK_USB,        // 160 MHz: nothing to save, and USB serial needs the PLL
+  POWER_LOCK_WIFI,       // 160 MHz
+  POWER_LOCK_SONG,       // 80 MHz
+  POWER_LOCK_ANIMATION,  // 80 MHz, while a pattern changes the frame
+  POWER_LOCK_SHOW,       // 80 MHz: the RMT timing of FastLED.show() needs an 80 MHz APB clock
+  NUM_POWER_LOCKS
+};
+
+enum PowerLevel : uint8_t {
+  POWER_160MHZ,
+  POWER_80MHZ,
+  POWER_40MHZ,  // no lock held
+  NUM_POWER_LEVELS
+};
+
+struct PowerStats {
+  uint32_t clockChanges;
+  uint64_t awakeMs[NUM_POWER_LEVELS];
+  uint64_t sleepMs;  // light sleep
+};
+
+// Sets up esp_pm or the fallback; call again after a wake-up from deep sleep
+void powerBegin();
+
+// Takes or drops a subsystem's lock; the clock changes at once if it has to
+void powerHold(PowerLock lock, bool held);
+
+// Time idleUntil() spent in light sleep
+void powerSlept(uint32_t ms);
+
+PowerLevel powerLevel();
+
+const PowerStats& powerStats();
+
+// Charge the chip drew since powerBegin() by the clock model, in uA*ms
+// (radio, LEDs and buzzer not included)
+uint64_t powerCharge();
+
+// Average supply current in per mille of running awake at 160 MHz
+uint32_t powerDutyPermille();
+
+// Time at each clock and asleep, and the current-equivalent duty
+void powerPrintStats();
+
+#endif // POWER_MANAGER_H
@@ -0,0 +1,44 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+
+// Cooperative deadline scheduler.
+// Every subsystem is a task that returns how many milliseconds it can wait
+// before it has to run again. loop() runs whatever is due and then idles
+// until the earliest deadline instead of polling everything on every pass.
+
+typedef uint32_t (*TaskFunction)(uint32_t now);
+
+struct Task {
+  const char* name;
+  TaskFunction run;
+  uint32_t due;
+};
+
+// Longest a task may wait when it only reacts to events (another task wakes it)
+const uint32_t TASK_IDLE = 60000;
+
+// Signed distance to a deadline, safe across millis() rollover
+inline int32_t timeUntil(uint32_t deadline, uint32_t now) {
+  return (int32_t)(deadline - now);
+}
+
+// Makes every task due now; call once from setup() since millis() may start anywhere
+inline void startTasks(Task* tasks, uint8_t count, uint32_t now) {
+  for (uint8_t i = 0; i < count; i++) {
+    tasks[i].due = now;
+  }
+}
+
+// Runs every due task in table order, returns the earliest next deadline.
+// Each task is checked against millis() when its turn comes, so one woken by
+// an earlier task in the same pass runs in that pass.
+uint32_t runDueTasks(Task* tasks, uint8_t count);
+
+// Makes a task due right away (it runs on this pass if it comes later in the table)
+inline void wakeTask(Task& task) {
+  task.due = millis();
+}
+
+#endif // SCHEDULER_H
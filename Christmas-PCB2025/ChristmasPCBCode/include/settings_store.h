@@ -0,0 +1,53 @@
+#ifndef SETTINGS_STORE_H
+#define SETTINGS_STORE_H
+
+#include <Arduino.h>
+
+// Persistent state.
+// Settings live in NVS as one blob with a schema version and a CRC, so loading
+// them is one read and a commit (only when something changed) one write; the
+// caller batches changes into commits. The uptime counter moves every second,
+// so it is kept in RTC memory (survives resets and sleep) and only every
+// UPTIME_LOG_INTERVAL seconds appended to the "uptimelog" flash partition, an
+// append-only ring of records that survives power loss. Taking the batteries
+// out loses at most UPTIME_LOG_INTERVAL of uptime. Time spent in deep sleep
+// counts as uptime: it is taken from the RTC clock when the board wakes.
+
+const uint32_t UPTIME_LOG_INTERVAL = 600;  // s between log records
+
+struct StoredSettings {
+  uint8_t displayMode;
+  uint8_t colorIndex;
+  uint8_t songIndex;
+  bool timerEnabled;
+  uint64_t cycleStart;  // uptime (s) at which the timer cycle started
+  uint16_t consumedMah; // drawn from the batteries (fuel_gauge.h)
+};
+
+struct StoreStats {
+  uint32_t commits;      // settings blob writes
+  uint32_t nvsWrites;    // blob and (without the log partition) uptime writes
+  uint32_t logRecords;   // uptime records appended
+  uint32_t logErases;    // sectors
+  uint32_t flashBytes;   // NVS entries and log records written this boot
+};
+
+// Loads the settings over the defaults already in settings, and the uptime
+void storeBegin(StoredSettings& settings, uint64_t& uptimeSeconds);
+
+// Writes the blob if the settings differ from what is stored; false if not
+bool storeCommit(const StoredSettings& settings);
+
+// Call once per uptime second; appends a log record every UPTIME_LOG_INTERVAL
+void storeUptime(uint64_t uptimeSeconds);
+
+// Call right before deep sleep: logs the uptime and notes the RTC time, so
+// storeBegin() after the wake-up adds the time asleep
+void storeDeepSleep(uint64_t uptimeSeconds);
+
+const StoreStats& storeStats();
+
+// Flash written this boot and per hour
+void storePrintStats();
+
+#endif // SETTINGS_STORE_H
@@ -0,0 +1,223 @@
+// Generated by scripts/build_web.py from web/index.html - do not edit.
+// 10989 bytes raw, 9175 minified, 3313 gzipped
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <Arduino.h>
+
+#define WEB_INDEX_ETAG "\"e527e7e4c6678d67\""
+
+const size_t WEB_INDEX_GZ_LENGTH = 3313;
+
+const uint8_t webIndexGz[WEB_INDEX_GZ_LENGTH] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xb5, 0x5a, 0xdb, 0x8e, 0xdb, 0xc6,
+  0x19, 0xbe, 0xf7, 0x53, 0x8c, 0x65, 0x24, 0x92, 0x1a, 0x51, 0xa2, 0x4e, 0x9b, 0x35, 0x75, 0x48,
+  0xf7, 0xa0, 0x6d, 0x8c, 0xae, 0xed, 0xc5, 0x6a, 0x93, 0xc0, 0x58, 0x2c, 0x82, 0x11, 0x39, 0x92,
+  0x98, 0xa5, 0x48, 0x96, 0x43, 0xad, 0xa4, 0x28, 0x02, 0x72, 0x91, 0xf4, 0xaa, 0x48, 0xd0, 0xfb,
+  0x06, 0x01, 0x7a, 0x95, 0xcb, 0xde, 0xa4, 0x68, 0x5f, 0xc7, 0x2f, 0xd0, 0x3c, 0x42, 0xff, 0x7f,
+  0x66, 0x78, 0xd4, 0xc1, 0x5b, 0x03, 0xb5, 0xbd, 0x96, 0x38, 0x33, 0xff, 0xf9, 0xf4, 0x0d, 0xed,
+  0xee, 0xd3, 0xf3, 0xd7, 0x67, 0x37, 0x6f, 0xae, 0x06, 0x64, 0x1a, 0xce, 0x9c, 0x7e, 0x57, 0xfd,
+  0xcd, 0xa8, 0xd5, 0xef, 0xce, 0x58, 0x48, 0x89, 0x39, 0xa5, 0x01, 0x67, 0x61, 0xaf, 0xf0, 0xd9,
+  0xcd, 0x85, 0x76, 0x5c, 0x50, 0xab, 0x2e, 0x9d, 0xb1, 0x5e, 0xe1, 0xc1, 0x66, 0x0b, 0xdf, 0x0b,
+  0xc2, 0x02, 0x31, 0x3d, 0x37, 0x64, 0x2e, 0x9c, 0x5a, 0xd8, 0x56, 0x38, 0xed, 0x59, 0xec, 0xc1,
+  0x36, 0x99, 0x26, 0x1e, 0x2a, 0xc4, 0x76, 0xed, 0xd0, 0xa6, 0x8e, 0xc6, 0x4d, 0xea, 0xb0, 0x5e,
+  0xbd, 0xaa, 0x03, 0x97, 0xd0, 0x0e, 0x1d, 0xd6, 0x3f, 0x9b, 0x06, 0x36, 0x0f, 0x67, 0x94, 0x93,
+  0xab, 0xb3, 0x53, 0x72, 0x06, 0x4c, 0x02, 0xcf, 0xe9, 0xd6, 0xe4, 0x66, 0x97, 0x87, 0x2b, 0xf8,
+  0x18, 0x79, 0xd6, 0x6a, 0x3d, 0xa3, 0xc1, 0xc4, 0x76, 0x0d, 0xbd, 0xe3, 0x53, 0xcb, 0xb2, 0xdd,
+  0x89, 0xd1, 0xd0, 0xfd, 0x65, 0x67, 0x0c, 0x04, 0xda, 0x98, 0xce, 0x6c, 0x67, 0x65, 0x14, 0x4f,
+  0x02, 0x90, 0x51, 0xac, 0x70, 0xea, 0x72, 0x8d, 0xb3, 0xc0, 0x1e, 0x77, 0x46, 0xd4, 0xbc, 0x9f,
+  0x04, 0xde, 0xdc, 0xb5, 0x0c, 0xc7, 0x76, 0x19, 0x0d, 0xb4, 0x49, 0x40, 0x2d, 0x1b, 0xf4, 0x2c,
+  0xd5, 0x9b, 0x6d, 0x8b, 0x4d, 0x2a, 0xcf, 0xea, 0xb4, 0x41, 0xeb, 0x94, 0xe8, 0x1f, 0x54, 0x9e,
+  0xe9, 0x56, 0x7d, 0xac, 0x5b, 0xa4, 0xae, 0xeb, 0x1f, 0x94, 0x3b, 0xa6, 0xe7, 0x78, 0x81, 0xf1,
+  0x6c, 0x3c, 0x1e, 0x77, 0xbc, 0x07, 0x16, 0x8c, 0x1d, 0x6f, 0xa1, 0x2d, 0x8d, 0xa9, 0x6d, 0x59,
+  0xcc, 0xed, 0xf8, 0x1e, 0x07, 0x83, 0x3c, 0xd7, 0x08, 0x98, 0x43, 0x43, 0xfb, 0x81, 0x75, 0x66,
+  0xb6, 0xab, 0x4d, 0x99, 0x3d, 0x99, 0x86, 0x06, 0xd0, 0x3f, 0x4c, 0x37, 0x55, 0xee, 0x7a, 0x8b,
+  0xb1, 0x43, 0xef, 0xd9, 0x3a, 0x3e, 0x4d, 0x47, 0xdc, 0x73, 0xe6, 0x21, 0xeb, 0x84, 0x9e, 0x6f,
+  0x68, 0x75, 0x34, 0x20, 0x11, 0x83, 0x92, 0x84, 0x39, 0xdc, 0xfe, 0x9a, 0x19, 0x75, 0x36, 0xeb,
+  0xcc, 0xc1, 0x08, 0x30, 0xc4, 0x61, 0x66, 0x68, 0xb8, 0x9e, 0xcb, 0x40, 0xac, 0x0d, 0x4e, 0x0e,
+  0x34, 0xf6, 0x00, 0x16, 0x70, 0xb9, 0x46, 0x5d, 0x7b, 0x46, 0x91, 0xbb, 0x86, 0x11, 0x31, 0xc6,
+  0xd4, 0x71, 0x52, 0x6b, 0xa1, 0x0d, 0x8a, 0x4d, 0xb4, 0xf1, 0xdc, 0x35, 0x85, 0x06, 0xd2, 0x0b,
+  0xa9, 0x03, 0x36, 0xf0, 0x93, 0xdf, 0x4c, 0x70, 0x53, 0x68, 0xd8, 0xee, 0x18, 0x83, 0xc5, 0x36,
+  0xbf, 0xbf, 0x67, 0xab, 0x71, 0x00, 0x2c, 0x39, 0x41, 0x9e, 0xeb, 0xd0, 0x5b, 0x87, 0x01, 0x78,
+  0x76, 0xec, 0x05, 0x33, 0x43, 0x7c, 0x03, 0xcb, 0xd9, 0x9b, 0x92, 0xb0, 0xb6, 0x4c, 0x02, 0x2f,
+  0x84, 0xc7, 0x52, 0xf3, 0x48, 0x07, 0xaf, 0x96, 0x37, 0x9b, 0x2a, 0xe6, 0x03, 0x05, 0x69, 0x01,
+  0x44, 0x6e, 0x29, 0xf3, 0xc0, 0x68, 0xeb, 0x68, 0x72, 0x14, 0x49, 0x42, 0xe7, 0xa1, 0x97, 0x0e,
+  0x51, 0x30, 0x19, 0x51, 0x88, 0xcb, 0xf3, 0x8a, 0x8e, 0xbf, 0xab, 0xf5, 0x76, 0xb9, 0x33, 0xf2,
+  0x02, 0x0b, 0x0c, 0xc6, 0xa0, 0xcd, 0xb9, 0x51, 0x6f, 0x03, 0x79, 0x26, 0xfe, 0x48, 0x6d, 0x05,
+  0x9e, 0xaf, 0x8d, 0x6d, 0x07, 0x2c, 0x31, 0x46, 0xce, 0x3c, 0x28, 0xa1, 0x63, 0x23, 0x52, 0xa3,
+  0xe1, 0x2f, 0x09, 0x78, 0xdd, 0xb6, 0xc8, 0xb3, 0xe3, 0x53, 0x1d, 0x7e, 0xc1, 0xc6, 0x52, 0xe3,
+  0x53, 0x6a, 0x79, 0x0b, 0xd0, 0xe1, 0x18, 0xb6, 0x9b, 0x78, 0x26, 0x27, 0xbc, 0x59, 0xde, 0x11,
+  0xe4, 0xaf, 0x35, 0xdb, 0xb5, 0xd8, 0xd2, 0xa8, 0x6f, 0xa6, 0xf5, 0x75, 0xc8, 0x96, 0xa1, 0x46,
+  0x1d, 0x7b, 0xe2, 0x1a, 0x26, 0xc3, 0xb0, 0xa4, 0xa2, 0xd7, 0xa8, 0x36, 0x20, 0x7e, 0xb1, 0xa1,
+  0x3a, 0x41, 0x65, 0x89, 0x9e, 0x44, 0xfb, 0x68, 0x74, 0x34, 0xea, 0x08, 0x0e, 0xb1, 0x26, 0xa8,
+  0x44, 0x2b, 0x52, 0x44, 0x57, 0x6a, 0xa0, 0x0b, 0xf6, 0xe7, 0x70, 0x4b, 0xa6, 0xb0, 0x64, 0x87,
+  0x9f, 0xd6, 0xf3, 0xa6, 0x55, 0xee, 0x68, 0x0b, 0x36, 0xba, 0xb7, 0x43, 0x2d, 0xa1, 0xd4, 0x4c,
+  0xc7, 0xf6, 0x0d, 0x94, 0x17, 0x6f, 0x0a, 0xe1, 0xe0, 0x35, 0x47, 0x93, 0x4a, 0x89, 0x90, 0xfa,
+  0x34, 0x00, 0xbe, 0x9d, 0x5d, 0x84, 0x9b, 0xea, 0x24, 0x60, 0x2c, 0x04, 0xcf, 0x1f, 0xb4, 0xbc,
+  0x5e, 0x6d, 0x26, 0x96, 0x2b, 0xab, 0xa3, 0x88, 0x89, 0xf0, 0xe5, 0xe3, 0xdd, 0x6c, 0x55, 0xd0,
+  0xeb, 0xf0, 0x21, 0x9c, 0x9e, 0x0b, 0xb8, 0x88, 0xb1, 0x0c, 0x64, 0x3d, 0x09, 0x64, 0xa3, 0x71,
+  0x7c, 0xda, 0x68, 0x44, 0xde, 0x7c, 0xae, 0x0f, 0x06, 0xcf, 0x75, 0xa9, 0xc3, 0x42, 0x96, 0xe0,
+  0xc8, 0x73, 0x2c, 0x99, 0x82, 0xd0, 0x4d, 0x34, 0x14, 0xe7, 0xaf, 0xdf, 0x53, 0xa7, 0xc6, 0xff,
+  0xa4, 0x53, 0x4e, 0x28, 0x71, 0xe8, 0x88, 0x39, 0x6b, 0xcb, 0xe6, 0xbe, 0x43, 0x57, 0x90, 0x9d,
+  0x9e, 0x79, 0xaf, 0x9c, 0xa3, 0x8d, 0xbc, 0x30, 0xf4, 0x66, 0xc6, 0x71, 0xd4, 0xc5, 0x52, 0xaa,
+  0x27, 0x79, 0x82, 0x01, 0xdd, 0xc8, 0x16, 0x50, 0xb1, 0x5d, 0x7f, 0x1e, 0xde, 0x86, 0x2b, 0x9f,
+  0xf5, 0x20, 0x56, 0x13, 0x76, 0xb7, 0x96, 0x55, 0x85, 0xfd, 0x2a, 0xb1, 0x27, 0xd1, 0x2e, 0x52,
+  0xf8, 0x38, 0xd1, 0x77, 0x47, 0x31, 0xe4, 0x4c, 0x6f, 0xb4, 0xdb, 0x95, 0xe8, 0x47, 0xaf, 0x3e,
+  0x6f, 0xc7, 0x8d, 0xb0, 0x61, 0xb5, 0xf5, 0xfa, 0x51, 0x3a, 0xd2, 0x47, 0xc0, 0x57, 0x64, 0x8d,
+  0x6a, 0x6e, 0x8e, 0x43, 0x20, 0x84, 0x9c, 0x30, 0xca, 0x99, 0xd2, 0xd9, 0x18, 0x7b, 0xe6, 0x9c,
+  0x6f, 0x6b, 0x2e, 0xd7, 0xd7, 0xde, 0x3c, 0xc4, 0x94, 0x96, 0x8d, 0x4c, 0x29, 0x9d, 0x2d, 0x91,
+  0x4c, 0xad, 0xea, 0x04, 0xad, 0x23, 0xb1, 0x9e, 0x75, 0xfd, 0x63, 0xf1, 0x83, 0x65, 0xb2, 0xd9,
+  0xf6, 0x4e, 0xe4, 0x12, 0xbd, 0xa3, 0x1a, 0x73, 0x23, 0x17, 0xeb, 0x7c, 0x39, 0x85, 0x1e, 0x09,
+  0xf0, 0x60, 0x45, 0x05, 0x33, 0xaa, 0xac, 0x1d, 0xcc, 0x0d, 0x23, 0xaa, 0x23, 0x0e, 0xde, 0x04,
+  0xb5, 0xc3, 0xe9, 0x7c, 0x36, 0x5a, 0x53, 0xdf, 0x07, 0x8e, 0xd4, 0x35, 0x95, 0x4d, 0x32, 0x40,
+  0x42, 0x6e, 0x46, 0x87, 0x4c, 0x7c, 0xda, 0x10, 0xbe, 0x94, 0x56, 0x2a, 0xea, 0xfb, 0x43, 0x66,
+  0xce, 0x03, 0x0e, 0x2e, 0x52, 0xc3, 0x60, 0x53, 0x75, 0x98, 0xa5, 0xe1, 0x1c, 0x8e, 0xd3, 0x6c,
+  0xec, 0xb0, 0x65, 0xe7, 0xab, 0x39, 0x0f, 0xed, 0xf1, 0x4a, 0x53, 0x73, 0x39, 0xaa, 0xd4, 0x09,
+  0xf5, 0x45, 0x42, 0xa8, 0x6a, 0x10, 0x0e, 0xd5, 0x13, 0x1e, 0xc4, 0xb2, 0x1f, 0x54, 0x5a, 0x35,
+  0x5a, 0x29, 0xad, 0x5b, 0xef, 0xd4, 0x5a, 0x76, 0xd6, 0x7c, 0x55, 0xb4, 0x5a, 0xad, 0x4d, 0xf5,
+  0x81, 0x3a, 0x73, 0xa6, 0x29, 0xed, 0xde, 0xd1, 0x3d, 0x92, 0xbe, 0xa9, 0xe1, 0x90, 0x6c, 0xa7,
+  0x47, 0xa4, 0x70, 0xcb, 0x56, 0x99, 0x8f, 0xe6, 0x50, 0x47, 0xee, 0xce, 0x5a, 0x68, 0xe5, 0x0d,
+  0x8d, 0x34, 0x4c, 0x27, 0x5c, 0xba, 0xac, 0x73, 0xd9, 0xbd, 0x5d, 0x97, 0x19, 0xd7, 0xef, 0xcd,
+  0x7e, 0xd9, 0xd9, 0x93, 0x71, 0x39, 0x87, 0xb4, 0x08, 0x4c, 0xdc, 0x70, 0x58, 0x88, 0x03, 0x1c,
+  0x1a, 0xad, 0x29, 0x34, 0xf4, 0x97, 0x4a, 0x7f, 0x63, 0x8a, 0x28, 0x63, 0xf7, 0x88, 0xd5, 0x1a,
+  0x72, 0x9e, 0xa5, 0x4a, 0x01, 0xfc, 0x42, 0xb0, 0x75, 0x65, 0xa7, 0x45, 0xb3, 0x1c, 0x71, 0xa3,
+  0x26, 0x0e, 0xac, 0xdd, 0xec, 0xf4, 0xf2, 0xa6, 0x3a, 0x0a, 0x5d, 0x0d, 0x92, 0xd5, 0x59, 0xad,
+  0xdf, 0x3d, 0x5e, 0xa2, 0x62, 0x68, 0x36, 0xce, 0xce, 0x9b, 0x8d, 0xa8, 0x21, 0x2c, 0xa6, 0x80,
+  0x12, 0x76, 0x24, 0xa9, 0xae, 0x1f, 0xb5, 0x74, 0x5d, 0x4a, 0xe0, 0x1e, 0x4c, 0x8b, 0x77, 0x0b,
+  0x90, 0x79, 0x5d, 0x79, 0x76, 0x71, 0x81, 0x9f, 0xef, 0x12, 0x70, 0x8c, 0x87, 0x40, 0x00, 0x07,
+  0xc0, 0x01, 0x3d, 0x64, 0x3b, 0x9d, 0xe2, 0xf0, 0x37, 0xb6, 0xc3, 0xbf, 0xab, 0xdb, 0xd5, 0xdb,
+  0xc2, 0x79, 0x5b, 0x8d, 0xfe, 0x38, 0x93, 0x10, 0xd0, 0x0c, 0x21, 0x35, 0xb7, 0x33, 0xfc, 0xe2,
+  0xe2, 0xfc, 0x63, 0x3d, 0x9e, 0xec, 0xf2, 0x09, 0xa6, 0x40, 0x04, 0x6b, 0x35, 0x04, 0xd2, 0x18,
+  0xd8, 0x03, 0x59, 0x9f, 0x4c, 0xcc, 0x68, 0x28, 0x88, 0x64, 0x8c, 0x41, 0x9a, 0x31, 0x01, 0xf0,
+  0x49, 0x1a, 0x32, 0xb7, 0x00, 0x82, 0x68, 0xd0, 0x37, 0x49, 0x04, 0xd4, 0x08, 0x45, 0xe0, 0xe3,
+  0xd2, 0x2c, 0x64, 0x43, 0x8a, 0xf5, 0x38, 0xf0, 0x66, 0xeb, 0x2c, 0xc8, 0x50, 0x2d, 0x14, 0x8a,
+  0x49, 0xb8, 0x3c, 0x86, 0x26, 0xe9, 0x85, 0xa6, 0x5a, 0xc0, 0xd6, 0xb7, 0x41, 0xd8, 0x97, 0xe3,
+  0x20, 0x09, 0x74, 0x1d, 0x49, 0x52, 0x04, 0xa9, 0x85, 0x96, 0x58, 0x78, 0xae, 0x33, 0xf6, 0x5c,
+  0x07, 0x28, 0xe8, 0x05, 0x08, 0x4d, 0xdd, 0x30, 0x6e, 0x50, 0xb6, 0x8b, 0x99, 0xa0, 0xa5, 0xc7,
+  0xa1, 0x21, 0x35, 0x4b, 0x19, 0x3d, 0x82, 0x30, 0x99, 0x0c, 0xcd, 0xde, 0x85, 0x49, 0xe5, 0xee,
+  0x1a, 0x60, 0x3b, 0x96, 0xfc, 0xde, 0x44, 0x6f, 0xef, 0xdb, 0x13, 0xe8, 0x1b, 0x71, 0xea, 0x88,
+  0x62, 0x45, 0xae, 0xc0, 0xad, 0x63, 0xef, 0x50, 0x32, 0xe9, 0x8f, 0x4b, 0xa6, 0x78, 0x74, 0xd6,
+  0xcb, 0xfb, 0xc7, 0x70, 0x2a, 0x7d, 0x54, 0x57, 0xdb, 0xd1, 0xe3, 0x92, 0xac, 0xdb, 0x74, 0x6b,
+  0xf2, 0x22, 0xd4, 0xad, 0xc9, 0x6b, 0x19, 0x5e, 0x88, 0xfa, 0x5d, 0x68, 0xd5, 0xc4, 0xb6, 0x7a,
+  0x85, 0xf8, 0xa2, 0xc1, 0xe1, 0x56, 0x55, 0x83, 0x55, 0xb9, 0x65, 0x3a, 0x94, 0xf3, 0x5e, 0x21,
+  0xc6, 0xe1, 0x85, 0xec, 0x72, 0x2e, 0x41, 0x0b, 0xa9, 0x9b, 0xd8, 0xe9, 0xc9, 0xe5, 0x25, 0x5e,
+  0xc7, 0x14, 0xb3, 0x69, 0xbd, 0xaf, 0xee, 0x65, 0xe4, 0x8a, 0xba, 0x0c, 0x6e, 0x67, 0xb0, 0x92,
+  0xe6, 0x15, 0x01, 0xc3, 0x42, 0xff, 0xc2, 0xfe, 0xca, 0x65, 0xe4, 0x9e, 0x05, 0x3c, 0x24, 0x67,
+  0x94, 0x43, 0xd7, 0x7b, 0x4a, 0x7e, 0xfb, 0xf9, 0x87, 0xef, 0x77, 0xab, 0x15, 0xc3, 0x24, 0x50,
+  0x4d, 0x00, 0xa5, 0xfe, 0x6f, 0x3f, 0xff, 0xf5, 0x5b, 0x72, 0x09, 0x9d, 0x8b, 0x7c, 0x0e, 0xc3,
+  0xa8, 0x5b, 0x93, 0xab, 0x69, 0xba, 0x68, 0x50, 0x15, 0x84, 0xe9, 0xf0, 0x84, 0x07, 0x63, 0xbb,
+  0xd5, 0x79, 0x31, 0xae, 0x89, 0x18, 0xd7, 0x60, 0x28, 0x33, 0xef, 0xa1, 0x77, 0x4a, 0x02, 0x3f,
+  0x60, 0x92, 0xda, 0x73, 0xe1, 0x5a, 0x0b, 0x93, 0xbc, 0x57, 0x08, 0xbd, 0xc9, 0xc4, 0x61, 0x57,
+  0x72, 0xa3, 0x14, 0x4e, 0x6d, 0x5e, 0x15, 0x34, 0xcc, 0x2a, 0x17, 0xfa, 0x64, 0x38, 0x85, 0xd2,
+  0x0b, 0xa7, 0x8c, 0x5c, 0x0e, 0xce, 0x39, 0x71, 0x40, 0xb5, 0x58, 0xab, 0x47, 0xda, 0xf4, 0xf6,
+  0x6f, 0xbf, 0x90, 0x53, 0x81, 0x2b, 0x5c, 0xc6, 0x79, 0x44, 0x4d, 0x32, 0x4a, 0x0a, 0x50, 0x21,
+  0x35, 0x1c, 0xc5, 0x47, 0x0b, 0x04, 0xee, 0x6e, 0xbd, 0x42, 0x5d, 0x87, 0x2f, 0x74, 0xd9, 0x2b,
+  0x40, 0x5e, 0x15, 0x88, 0x98, 0xa5, 0xbd, 0xc2, 0x91, 0x8e, 0x26, 0x08, 0x16, 0xbd, 0xc2, 0xdc,
+  0xb7, 0x20, 0xa7, 0x13, 0x19, 0xd2, 0x08, 0x71, 0xb2, 0x9c, 0x8d, 0x7a, 0x66, 0x12, 0xe7, 0xe5,
+  0x7d, 0x4e, 0x9d, 0x42, 0xff, 0x48, 0x57, 0x76, 0x3d, 0x3a, 0x62, 0x3f, 0xfc, 0x82, 0xbe, 0x81,
+  0xd4, 0xc0, 0x3a, 0x72, 0x63, 0xef, 0x48, 0x00, 0x28, 0x9d, 0x2e, 0xb7, 0x30, 0x4a, 0x72, 0xf5,
+  0xf1, 0xbe, 0xfb, 0xf1, 0x1f, 0xe4, 0x48, 0xfb, 0xd4, 0x83, 0xb1, 0xab, 0xbd, 0x7e, 0x45, 0x6e,
+  0xec, 0x19, 0x0b, 0x76, 0x49, 0x08, 0x71, 0x03, 0xa8, 0x3c, 0x1f, 0x5b, 0x47, 0xe4, 0x24, 0xbd,
+  0xd0, 0x3f, 0xb7, 0x39, 0x1d, 0x41, 0x96, 0x74, 0x6b, 0x72, 0x2b, 0x7f, 0xa4, 0x5e, 0xe8, 0x0f,
+  0xdc, 0xdc, 0x89, 0x9c, 0x92, 0x72, 0xa2, 0x46, 0x7a, 0xc6, 0x83, 0x53, 0xa4, 0x90, 0x63, 0x9b,
+  0xf7, 0xbd, 0x82, 0x78, 0x1e, 0xc2, 0x64, 0x87, 0x1a, 0xe0, 0x25, 0x70, 0xf9, 0x09, 0x2e, 0x90,
+  0x68, 0xa5, 0x5b, 0x93, 0x2c, 0x1e, 0xe7, 0xcd, 0x5f, 0xc9, 0x15, 0xc4, 0x86, 0x24, 0xd5, 0x38,
+  0x84, 0x21, 0xba, 0xcb, 0x66, 0x1c, 0xae, 0x69, 0x97, 0x6e, 0xeb, 0x29, 0x4e, 0x24, 0x6a, 0x62,
+  0xcc, 0x91, 0x19, 0x6a, 0x28, 0x64, 0xe0, 0x03, 0x96, 0xe7, 0x3f, 0x63, 0x0d, 0xc9, 0xbb, 0xb9,
+  0x70, 0x80, 0x65, 0x11, 0x97, 0x21, 0x7c, 0x97, 0x5c, 0xde, 0xfe, 0xf8, 0xef, 0xff, 0xfc, 0xeb,
+  0xc7, 0xc4, 0xd2, 0xad, 0xf8, 0xca, 0x69, 0x2d, 0x53, 0x4e, 0x7d, 0xef, 0x5f, 0x43, 0xe7, 0x59,
+  0x11, 0x40, 0xdd, 0x1c, 0xca, 0x92, 0x5a, 0x29, 0x9b, 0xa1, 0x00, 0x55, 0xeb, 0xf8, 0x2e, 0x93,
+  0x8e, 0xdc, 0x0c, 0x6c, 0x3f, 0xec, 0x47, 0xaf, 0x33, 0x88, 0x09, 0x74, 0x21, 0x1b, 0xc6, 0x0d,
+  0xb0, 0x54, 0x26, 0xeb, 0x27, 0xe0, 0x5a, 0x68, 0x3f, 0x49, 0x57, 0x3c, 0x8b, 0x3a, 0x20, 0xe9,
+  0x11, 0x0b, 0xee, 0x1d, 0x38, 0x8a, 0xaa, 0x13, 0x16, 0x0e, 0x1c, 0x86, 0x5f, 0x4f, 0x57, 0x2f,
+  0xac, 0x52, 0x31, 0x39, 0x5e, 0x2c, 0x77, 0xb6, 0x58, 0x00, 0xe5, 0x6d, 0xf1, 0xed, 0x4f, 0xdf,
+  0x15, 0x2b, 0x04, 0x3e, 0xbe, 0x97, 0x1f, 0x7f, 0x16, 0x1f, 0xdf, 0xfe, 0xbd, 0x78, 0xd7, 0x79,
+  0x02, 0xe3, 0x85, 0x94, 0x00, 0xdc, 0x11, 0x1b, 0x8e, 0xea, 0x1d, 0xf8, 0xe8, 0x92, 0x36, 0x7e,
+  0x7e, 0xf4, 0xd1, 0x0e, 0x95, 0xd2, 0x8a, 0x48, 0x13, 0x94, 0x2e, 0xa5, 0x22, 0x98, 0x89, 0x0a,
+  0xc4, 0x47, 0xab, 0xc2, 0x7f, 0xaf, 0x60, 0xe6, 0x01, 0x51, 0xa2, 0x65, 0x31, 0x7d, 0x04, 0xa7,
+  0xd6, 0x99, 0x84, 0xf9, 0x70, 0x28, 0xd1, 0xfa, 0xf6, 0x25, 0x0d, 0xa7, 0xd5, 0xb1, 0xe3, 0x79,
+  0x41, 0x49, 0x7c, 0x85, 0x36, 0x63, 0x79, 0x33, 0x70, 0xd2, 0xef, 0x52, 0xa7, 0x00, 0xfb, 0xbb,
+  0x93, 0x70, 0x5a, 0xbe, 0x4b, 0xb3, 0x14, 0xf3, 0x06, 0x76, 0xc6, 0xc8, 0x31, 0x4f, 0x0b, 0x13,
+  0x97, 0x7c, 0x44, 0x8a, 0x0f, 0x8b, 0xe2, 0x36, 0x49, 0x3c, 0xbf, 0xcf, 0xe7, 0xf2, 0xbd, 0x12,
+  0xd0, 0x6f, 0x09, 0x6f, 0x03, 0x79, 0xbb, 0x8c, 0x3c, 0xf8, 0x41, 0x16, 0x0c, 0xb3, 0x74, 0x5b,
+  0x7e, 0x7b, 0x1f, 0xa5, 0x87, 0xb0, 0x3a, 0xdc, 0x45, 0xa2, 0x57, 0x3f, 0x06, 0x22, 0x40, 0xc8,
+  0xdb, 0x44, 0x38, 0x6c, 0x87, 0x30, 0x6b, 0x77, 0x29, 0x5a, 0x47, 0x43, 0xeb, 0xba, 0x50, 0xd5,
+  0x5f, 0xa6, 0x25, 0x26, 0x59, 0x55, 0xc5, 0x4b, 0x9f, 0x6b, 0x9d, 0x4d, 0x6d, 0xc7, 0x2a, 0xc5,
+  0xfb, 0x10, 0xc3, 0x0d, 0xfc, 0x7e, 0xa0, 0x01, 0x39, 0x7b, 0x79, 0xfe, 0xe5, 0xe9, 0xf5, 0x8b,
+  0x3f, 0x7c, 0x7a, 0xf3, 0x6a, 0x30, 0x1c, 0x82, 0x98, 0x7a, 0x45, 0xac, 0x5d, 0x9d, 0xdc, 0xdc,
+  0x0c, 0xae, 0x5f, 0xc1, 0x42, 0x43, 0x2e, 0xdc, 0xbc, 0x78, 0x39, 0xb8, 0x86, 0xc7, 0xa6, 0xda,
+  0xbf, 0x3c, 0x79, 0x03, 0x4f, 0x2d, 0xf9, 0x34, 0xbc, 0x79, 0x7d, 0x05, 0x4f, 0xed, 0x4e, 0xcc,
+  0xf3, 0xea, 0x7a, 0xf0, 0xf9, 0x8b, 0xc1, 0x17, 0x98, 0x70, 0xcb, 0xba, 0x2e, 0xd7, 0x87, 0x37,
+  0x27, 0x37, 0x83, 0x2f, 0x2f, 0xae, 0x4f, 0x5e, 0x0e, 0xc4, 0xfa, 0xb1, 0x5e, 0x21, 0xea, 0xdc,
+  0x97, 0x7f, 0x1c, 0xbc, 0x91, 0x6b, 0xf5, 0x64, 0xed, 0x7c, 0x70, 0x79, 0x73, 0x22, 0x57, 0x1b,
+  0x92, 0x03, 0x07, 0x4c, 0xc6, 0x30, 0xea, 0xee, 0xdc, 0x71, 0xe4, 0x12, 0x9a, 0x07, 0x8d, 0x2c,
+  0x19, 0x30, 0xf1, 0x6e, 0x52, 0x88, 0x9e, 0xeb, 0x42, 0x17, 0x1a, 0x0a, 0x62, 0x51, 0x85, 0x09,
+  0x1f, 0xb8, 0x55, 0x7e, 0xc1, 0x46, 0x6a, 0xab, 0xb8, 0xe0, 0x46, 0xad, 0x56, 0x04, 0x87, 0x02,
+  0xf8, 0x13, 0x51, 0xae, 0x4e, 0x3d, 0xa8, 0x0d, 0x70, 0x70, 0x6d, 0x21, 0x6a, 0x4f, 0x12, 0x56,
+  0x47, 0xb6, 0x4b, 0x83, 0xd5, 0x0d, 0x8c, 0x47, 0x4c, 0x7c, 0x1a, 0x04, 0x74, 0x35, 0x9a, 0x8f,
+  0xc7, 0x2c, 0x28, 0xc6, 0x47, 0x3c, 0xd7, 0x03, 0xd5, 0x60, 0x3b, 0x52, 0x43, 0x08, 0xb6, 0xc7,
+  0xa4, 0xb4, 0xb7, 0xcc, 0xd5, 0xfc, 0x2f, 0x96, 0xe3, 0x19, 0x4f, 0x72, 0xf3, 0x3f, 0x98, 0x8b,
+  0xd8, 0xa5, 0x84, 0x00, 0xdc, 0xe4, 0x74, 0xc2, 0xd2, 0x72, 0x18, 0x0a, 0x42, 0xd7, 0x58, 0xca,
+  0xc0, 0xcf, 0xe0, 0x42, 0x78, 0x7c, 0x82, 0x4a, 0x96, 0x58, 0x15, 0xa6, 0x31, 0x05, 0x1e, 0x42,
+  0x91, 0x5b, 0xfd, 0x8e, 0xf4, 0x7a, 0x99, 0xb8, 0x7c, 0xf8, 0x21, 0xb1, 0x54, 0xd1, 0x91, 0x7e,
+  0x0f, 0x0b, 0x81, 0x03, 0xc8, 0x18, 0x8a, 0xf7, 0xa7, 0x56, 0x8e, 0x2e, 0x1d, 0xbb, 0x6f, 0xbe,
+  0x21, 0xf9, 0x65, 0x11, 0x3e, 0x49, 0x1f, 0x19, 0x60, 0xe5, 0xb4, 0x37, 0x1d, 0x8f, 0xb3, 0xbc,
+  0x8f, 0x72, 0x41, 0xe6, 0x2c, 0xc4, 0xd1, 0x0a, 0xd7, 0x8a, 0x52, 0x26, 0x90, 0x15, 0xc0, 0xfa,
+  0x78, 0x21, 0x43, 0x86, 0x9b, 0x24, 0xd8, 0x1c, 0xd3, 0xdd, 0x9b, 0xcd, 0xa0, 0x4e, 0x78, 0x69,
+  0xb4, 0x0a, 0x19, 0x8f, 0xfc, 0xfe, 0x54, 0x31, 0x06, 0x55, 0x95, 0x02, 0xd8, 0xd8, 0x57, 0xc2,
+  0x36, 0xf2, 0xb4, 0x97, 0xe4, 0x41, 0xf5, 0xf5, 0xd5, 0xe0, 0x55, 0x99, 0x04, 0x2c, 0x9c, 0x07,
+  0x2e, 0xbe, 0x60, 0x86, 0xbb, 0x71, 0xa4, 0x33, 0xb2, 0x2f, 0xe5, 0x9c, 0x2a, 0xa5, 0x80, 0x26,
+  0x8a, 0x02, 0xc3, 0x94, 0xd5, 0x29, 0xe5, 0x42, 0x15, 0x1b, 0xf9, 0x66, 0xe6, 0x50, 0xd3, 0x4f,
+  0xb0, 0x4f, 0x31, 0xf2, 0x7b, 0x74, 0x54, 0x5e, 0xa0, 0xd5, 0x69, 0x54, 0x5d, 0x71, 0x83, 0xe0,
+  0xed, 0x28, 0x87, 0x9e, 0xf4, 0xa4, 0x70, 0xad, 0x38, 0x27, 0xd1, 0x17, 0xca, 0xbe, 0xad, 0x43,
+  0x63, 0x7d, 0x84, 0x06, 0x80, 0xbe, 0x20, 0x2b, 0x6d, 0xf0, 0x7e, 0x70, 0x03, 0xfd, 0x3c, 0x26,
+  0xdd, 0xec, 0x27, 0x56, 0xb8, 0x0a, 0xc8, 0x12, 0x69, 0x8d, 0x43, 0xd2, 0x04, 0x4c, 0xca, 0x1c,
+  0x6f, 0xde, 0x45, 0x55, 0x0f, 0x43, 0xfc, 0xd0, 0x78, 0x84, 0x7d, 0x20, 0x94, 0x10, 0x89, 0xdf,
+  0x5a, 0xb7, 0xad, 0x3b, 0xa2, 0x11, 0xd4, 0x0f, 0xbd, 0x86, 0xbb, 0x68, 0xfb, 0x7e, 0x72, 0x31,
+  0xf1, 0x73, 0xf6, 0x15, 0x11, 0x84, 0xe0, 0xdd, 0x8a, 0x60, 0x3b, 0x40, 0x1e, 0x62, 0x92, 0x61,
+  0x2b, 0xc0, 0xc9, 0xff, 0x6b, 0x51, 0xb6, 0xd0, 0x38, 0xc4, 0xf8, 0xb2, 0x7a, 0x28, 0xc0, 0x4e,
+  0xc9, 0xb6, 0x2a, 0xe2, 0x1f, 0xa0, 0x78, 0x1c, 0x6b, 0x89, 0x8b, 0xf6, 0x5b, 0x60, 0x63, 0x5d,
+  0x08, 0x12, 0x68, 0xf8, 0xc1, 0x80, 0x9a, 0xd3, 0x52, 0x5c, 0x11, 0xb8, 0x5c, 0x21, 0xb6, 0x88,
+  0x9e, 0xe0, 0x53, 0x85, 0x4b, 0x9f, 0xc8, 0xc0, 0xd7, 0x7e, 0xe6, 0x00, 0x56, 0x42, 0x39, 0x93,
+  0x76, 0x8e, 0x47, 0xad, 0x33, 0x28, 0x77, 0xc7, 0x9b, 0x88, 0xc2, 0x8a, 0x12, 0x9a, 0x85, 0x20,
+  0xa0, 0x58, 0xa3, 0xbe, 0x5d, 0x33, 0xe5, 0x76, 0xb1, 0xfc, 0xa4, 0x0a, 0xf7, 0x08, 0xb7, 0x04,
+  0x19, 0xd9, 0x27, 0x41, 0xf5, 0x2b, 0x8e, 0xb5, 0x18, 0x2d, 0x9a, 0xb8, 0xb8, 0x7e, 0x92, 0x32,
+  0x31, 0x8e, 0x6e, 0x85, 0x98, 0x55, 0xf5, 0x9d, 0x83, 0xf0, 0xf4, 0x11, 0x11, 0x15, 0xdc, 0xc7,
+  0x2f, 0x5c, 0x68, 0xf7, 0xa4, 0x0a, 0xf2, 0x40, 0x36, 0x93, 0x0c, 0xff, 0xc7, 0x88, 0x0c, 0x82,
+  0xc0, 0x03, 0xdc, 0xf5, 0xf6, 0xa7, 0xbf, 0x14, 0xb7, 0x4c, 0xcd, 0xf6, 0x49, 0xcf, 0x95, 0xee,
+  0x4a, 0x75, 0x82, 0xdb, 0xd4, 0x50, 0xaa, 0x00, 0x60, 0x24, 0x9f, 0x90, 0x3a, 0x31, 0x88, 0x7e,
+  0x57, 0xce, 0x75, 0x8f, 0xf0, 0x92, 0x59, 0x00, 0x96, 0x20, 0x86, 0xf0, 0xc7, 0x8f, 0x42, 0x28,
+  0xae, 0xc0, 0xa8, 0x04, 0x5c, 0xa6, 0x4b, 0x98, 0x11, 0xd6, 0xad, 0x7f, 0x87, 0xc9, 0x50, 0x51,
+  0x0f, 0x38, 0x8a, 0xf3, 0x0b, 0x0d, 0xb1, 0x50, 0x06, 0x6d, 0x81, 0x9f, 0x1a, 0xe8, 0xc9, 0xbd,
+  0x1c, 0xb8, 0x09, 0xae, 0x99, 0x5d, 0x6f, 0x39, 0x14, 0xef, 0x32, 0x50, 0x54, 0xfc, 0x42, 0x04,
+  0x39, 0xaa, 0xa3, 0xb9, 0xa6, 0x92, 0xf4, 0x55, 0xa5, 0xa7, 0x78, 0x4d, 0x7a, 0xa0, 0x54, 0xd4,
+  0x9d, 0xb4, 0xb8, 0xbf, 0x93, 0x23, 0xa7, 0x05, 0xc0, 0x05, 0x46, 0x4a, 0xc8, 0x0c, 0x46, 0x11,
+  0x40, 0x87, 0x80, 0xb9, 0xd1, 0x50, 0xe8, 0x8a, 0xd2, 0x2f, 0x0b, 0x49, 0x19, 0x74, 0x71, 0x10,
+  0x34, 0x96, 0x15, 0x0a, 0x45, 0x1d, 0x53, 0x28, 0x54, 0x74, 0x11, 0x89, 0x43, 0x95, 0xe7, 0x33,
+  0x32, 0x6f, 0xed, 0x3b, 0x11, 0x86, 0x06, 0x38, 0xc0, 0x06, 0xc4, 0xd3, 0xc4, 0x60, 0x11, 0x06,
+  0xfd, 0x18, 0xd3, 0x31, 0xe2, 0x77, 0x2f, 0xf9, 0xdd, 0xc7, 0xfc, 0xee, 0x25, 0xae, 0x15, 0xe8,
+  0x00, 0x01, 0x0c, 0x50, 0xdf, 0x03, 0x75, 0x4b, 0xda, 0x9c, 0x95, 0x80, 0x71, 0xbc, 0xdb, 0x23,
+  0x5d, 0xec, 0xc9, 0x3c, 0xc0, 0xf0, 0x2a, 0xd4, 0x94, 0x0a, 0xc1, 0xd6, 0xdd, 0x16, 0x7a, 0xd7,
+  0xc1, 0x56, 0x73, 0xa8, 0xa3, 0x02, 0xad, 0x54, 0xf0, 0x70, 0x0b, 0x0f, 0xd8, 0x9f, 0xe6, 0x8c,
+  0x87, 0x27, 0x11, 0x0e, 0xbd, 0xc0, 0x57, 0x4e, 0xa5, 0xec, 0x00, 0xdd, 0x4a, 0xfc, 0x04, 0xe1,
+  0x55, 0xb6, 0x27, 0x04, 0x96, 0xc0, 0x7e, 0x14, 0x25, 0x0b, 0x6d, 0xd7, 0xbe, 0x8f, 0xff, 0xf2,
+  0xfe, 0x02, 0x42, 0x8c, 0x56, 0x6f, 0xa5, 0xe6, 0x35, 0x83, 0x6b, 0x66, 0x49, 0x69, 0x5b, 0x21,
+  0x1c, 0xe0, 0x91, 0xbd, 0x44, 0xed, 0x64, 0xfb, 0x51, 0x1b, 0xb9, 0xbe, 0x83, 0x2d, 0x36, 0xe9,
+  0x3b, 0xd6, 0xfb, 0xb4, 0x09, 0x4b, 0xb4, 0x68, 0xd1, 0xb4, 0x85, 0xc8, 0xff, 0x6f, 0xdf, 0xc9,
+  0xdd, 0xae, 0x55, 0xd6, 0x8d, 0x1e, 0x3b, 0xd7, 0xe5, 0xb0, 0xeb, 0xc4, 0xa9, 0xfa, 0xd8, 0x69,
+  0x2a, 0x29, 0x0e, 0x8d, 0x94, 0xec, 0x38, 0x55, 0x93, 0xf0, 0x60, 0x5e, 0x8c, 0x32, 0xc0, 0x1f,
+  0xf2, 0x24, 0x85, 0xfb, 0x2b, 0x24, 0xbc, 0x2b, 0xbf, 0xc7, 0x10, 0x8d, 0x3c, 0x23, 0xfc, 0x64,
+  0x33, 0x4b, 0xde, 0x9a, 0x8b, 0xa9, 0x2a, 0x4e, 0x52, 0xa5, 0x58, 0x83, 0x22, 0xfc, 0x24, 0xf1,
+  0x4e, 0x0f, 0x63, 0x38, 0xc2, 0x68, 0x7e, 0xa8, 0xac, 0x17, 0x2b, 0xbe, 0x58, 0x11, 0xd6, 0x89,
+  0x67, 0xc8, 0xad, 0xa2, 0x60, 0x5a, 0xce, 0x4d, 0xe4, 0xe4, 0x8d, 0x42, 0x34, 0x86, 0x1f, 0x81,
+  0x21, 0x52, 0xde, 0x7a, 0xba, 0x63, 0x7e, 0xc0, 0xa5, 0x07, 0x52, 0x19, 0x5d, 0x91, 0xd6, 0x1b,
+  0x25, 0x7d, 0x82, 0x0c, 0x84, 0x42, 0x5c, 0x2a, 0xf4, 0x6b, 0x31, 0x57, 0x13, 0xf1, 0xab, 0x09,
+  0x05, 0x47, 0xb7, 0xd9, 0xe3, 0x2d, 0xaa, 0x82, 0x23, 0xe9, 0x7d, 0x3c, 0x8d, 0x18, 0x09, 0x65,
+  0xf8, 0xcc, 0x52, 0x2f, 0x3c, 0xf6, 0xba, 0x19, 0x4e, 0x89, 0xb7, 0x03, 0xf2, 0x94, 0xf2, 0xdb,
+  0xc2, 0x86, 0x8b, 0xe5, 0x02, 0x30, 0x39, 0xa2, 0x86, 0x3c, 0x24, 0xdf, 0x7e, 0x95, 0x01, 0x53,
+  0x2b, 0x8d, 0x2e, 0x14, 0x50, 0x48, 0xe3, 0x73, 0x81, 0xcc, 0xbb, 0x35, 0xf5, 0x56, 0xa4, 0x5b,
+  0x93, 0xef, 0x85, 0x6b, 0xe2, 0x7f, 0xf0, 0xfc, 0x17, 0x39, 0xfa, 0x9b, 0xec, 0xd7, 0x23, 0x00,
+  0x00,
+};
+
+#endif // WEB_ASSETS_H
@@ -0,0 +1,101 @@
+#ifndef WEB_PORTAL_H
+#define WEB_PORTAL_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+// Captive control portal on ESPAsyncWebServer (the same server ElegantOTA uses
+// with ELEGANTOTA_USE_ASYNC_WEBSERVER).
+// Requests are handled on the AsyncTCP task, never inside loop(). Handlers only
+// check their arguments and post a PortalCommand; loop() drains the queue and
+// applies the commands between frames, so a slow phone can't hold up an LED
+// frame or a note, and several phones can use the portal at once.
+//
+// GET /api/catalog lists the patterns (by web pattern number) and songs, built
+// from the pattern registry and songNames[]; GET /api/state is a JSON snapshot
+// of PortalState. Both carry an ETag and are only rebuilt when their content
+// changes, so polling them costs a 304 and no formatting.
+//
+// The page talks to the board over a WebSocket on /ws in binary frames (the
+// HTTP endpoints /set, /play and /stop remain as a fallback):
+//   phone -> board  one or more [command, value] byte pairs (PortalCommandType)
+//   board -> phone  [PORTAL_STATE_FRAME, brightness, pattern, timer, song + 1 or 0]
+//                   on connect and whenever loop() publishes a change
+//
+// Live view of the LEDs, for phones that sent [PORTAL_PREVIEW, 1]:
+//   [PORTAL_PREVIEW_KEY, n, r, g, b, ...]            all n LEDs
+//   [PORTAL_PREVIEW_DELTA, k, led, r, g, b, ...]     only the k LEDs that changed
+// Preview frames are built and sent from a task after the pattern task, never from
+// FastLED.show(); a governor caps the rate and skips frames while a socket is
+// backed up, so the preview can only lag, it never delays the strip.
+
+// Commands waiting for loop() (power of two)
+#define PORTAL_QUEUE_LENGTH 16
+
+// The numbers are also the WebSocket command bytes
+enum PortalCommandType : uint8_t {
+  PORTAL_SET_BRIGHTNESS = 1,  // value: 10-255
+  PORTAL_SET_PATTERN = 2,     // value: web pattern number (0/1 = static red/green, 2.. = next modes)
+  PORTAL_SET_TIMER = 3,       // value: 0 = off, 1 = on
+  PORTAL_PLAY_SONG = 4,       // value: song index
+  PORTAL_STOP_SONG = 5
+};
+
+const uint8_t PORTAL_STATE_FRAME = 0x80;
+const uint8_t PORTAL_STATE_FRAME_LENGTH = 5;
+
+const uint8_t PORTAL_PREVIEW = 0x10;        // socket command, handled by the portal itself
+const uint8_t PORTAL_PREVIEW_KEY = 0x81;
+const uint8_t PORTAL_PREVIEW_DELTA = 0x82;
+const uint32_t PORTAL_PREVIEW_INTERVAL = 100;   // ms, at most 10 preview frames/s
+const uint32_t PORTAL_KEYFRAME_INTERVAL = 2000; // ms, resyncs phones that missed a delta
+#define PORTAL_MAX_PREVIEWS 4
+
+struct PortalCommand {
+  PortalCommandType type;
+  int16_t value;
+};
+
+// What the phones are shown
+struct PortalState {
+  uint8_t brightness;
+  uint8_t pattern;       // web pattern number
+  uint8_t timer;         // 0 = off, 1 = on
+  uint8_t song;          // playing song + 1, 0 = none
+  uint8_t timerOnPhase;  // 1 while the timer is in its ON phase
+  uint8_t battery;       // 0 = USB, 1 = batteries
+  uint16_t minutesLeft;  // in the current timer phase
+};
+
+struct PortalStats {
+  uint32_t commands;
+  uint32_t dropped;       // queue full: a 503, or a socket command ignored
+  uint32_t socketFrames;  // command frames received over /ws
+  uint32_t statePushes;   // state changes sent to all sockets
+  uint32_t stateRequests; // GET /api/state, 304s included
+  uint32_t previewFrames;
+  uint32_t previewBytes;
+  uint32_t previewSkipped;  // a socket was still busy with earlier frames
+};
+
+// Registers the routes and starts the server (the AP must be up)
+void portalBegin();
+void portalEnd();
+
+// Takes the oldest pending command (call from loop()); false if there is none
+bool portalNextCommand(PortalCommand& command);
+
+// Pushes the state to every open socket if it changed and closes dead sockets
+// (call from loop()); handlers also answer from it
+void portalUpdate(const PortalState& state);
+
+// Sends the next preview frame of leds[NUM_LEDS] if a phone is watching and the
+// governor allows it (call from loop())
+void portalPreview(const CRGB* leds);
+
+const PortalStats& portalStats();
+
+// Page loads, probe hits and what answering probes with a redirect saved
+void portalPrintStats();
+
+#endif // WEB_PORTAL_H
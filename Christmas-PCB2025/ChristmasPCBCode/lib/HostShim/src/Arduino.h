@@ -0,0 +1,124 @@
+// Host shim for the subset of the Arduino-ESP32 core used by the firmware
+#ifndef ARDUINO_H_HOST_SHIM
+#define ARDUINO_H_HOST_SHIM
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+
+#define PROGMEM
+#define PGM_P const char *
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define memcpy_P memcpy
+
+// Survives resets and sleep on the board; plain RAM here
+#define RTC_NOINIT_ATTR
+#define RTC_DATA_ATTR
+
+class __FlashStringHelper;
+#define FPSTR(p) (reinterpret_cast<const __FlashStringHelper *>(p))
+#define F(s) FPSTR(s)
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+// Time is 32-bit on the C3, so keep it 32-bit here to get the same rollover
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t val);
+uint16_t analogRead(uint8_t pin);
+uint32_t analogReadMilliVolts(uint8_t pin);  // ideal 3.3 V reference on the host
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+bool setCpuFrequencyMhz(uint32_t cpu_freq_mhz);
+uint32_t getCpuFrequencyMhz();
+
+class String {
+public:
+  String() {}
+  String(const char *s) : s_(s ? s : "") {}
+  String(const __FlashStringHelper *s) : s_(reinterpret_cast<const char *>(s)) {}
+  String(const std::string &s) : s_(s) {}
+  explicit String(char c) : s_(1, c) {}
+  explicit String(int v) : s_(std::to_string(v)) {}
+  explicit String(unsigned int v) : s_(std::to_string(v)) {}
+  explicit String(long v) : s_(std::to_string(v)) {}
+  explicit String(unsigned long v) : s_(std::to_string(v)) {}
+
+  const char *c_str() const { return s_.c_str(); }
+  unsigned int length() const { return s_.length(); }
+  long toInt() const { return strtol(s_.c_str(), nullptr, 10); }
+  bool equals(const char *s) const { return s_ == s; }
+  bool operator==(const char *s) const { return s_ == s; }
+  bool operator==(const String &o) const { return s_ == o.s_; }
+  String &operator+=(const String &o) { s_ += o.s_; return *this; }
+  String &operator+=(const char *s) { s_ += s; return *this; }
+  friend String operator+(const String &a, const String &b) { return String(a.s_ + b.s_); }
+  friend String operator+(const String &a, const char *b) { return String(a.s_ + b); }
+  friend String operator+(const char *a, const String &b) { return String(a + b.s_); }
+
+private:
+  std::string s_;
+};
+
+class IPAddress;
+
+class HardwareSerial {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  void flush() {}
+  void print(const char *s);
+  void print(const String &s) { print(s.c_str()); }
+  void print(const __FlashStringHelper *s) { print(reinterpret_cast<const char *>(s)); }
+  void print(char c);
+  void print(int v);
+  void print(unsigned int v);
+  void print(long v);
+  void print(unsigned long v);
+  void print(double v, int digits = 2);
+  void print(const IPAddress &ip);
+  template <typename T> void println(const T &v) { print(v); print("\n"); }
+  void println(double v, int digits) { print(v, digits); print("\n"); }
+  void println() { print("\n"); }
+  int printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern HardwareSerial Serial;
+
+// Heap figures come from the shim's heap model (hostshim::heapModelBegin)
+class EspClass {
+public:
+  uint32_t getHeapSize();
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getMaxAllocHeap();
+};
+
+extern EspClass ESP;
+
+#endif // ARDUINO_H_HOST_SHIM
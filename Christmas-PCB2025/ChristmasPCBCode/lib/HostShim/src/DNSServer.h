@@ -0,0 +1,17 @@
+// Host shim for the captive-portal DNS server
+#ifndef DNSSERVER_H_HOST_SHIM
+#define DNSSERVER_H_HOST_SHIM
+
+#include <WiFi.h>
+
+class DNSServer {
+public:
+  bool start(uint16_t port, const String &domainName, const IPAddress &resolvedIP) {
+    (void)port; (void)domainName; (void)resolvedIP;
+    return true;
+  }
+  void stop() {}
+  void processNextRequest() {}
+};
+
+#endif // DNSSERVER_H_HOST_SHIM
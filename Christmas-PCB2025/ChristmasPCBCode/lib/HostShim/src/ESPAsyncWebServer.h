@@ -0,0 +1,218 @@
+// Host shim for ESPAsyncWebServer. No sockets are opened; handlers only run
+// when a host tool injects a request, on the caller's thread.
+#ifndef ESPASYNCWEBSERVER_H_HOST_SHIM
+#define ESPASYNCWEBSERVER_H_HOST_SHIM
+
+#include <WiFi.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+typedef uint8_t WebRequestMethodComposite;
+enum WebRequestMethod : uint8_t {
+  HTTP_GET = 0x01,
+  HTTP_POST = 0x02,
+  HTTP_ANY = 0xFF
+};
+
+class AsyncWebParameter {
+public:
+  AsyncWebParameter(const String &name, const String &value) : name_(name), value_(value) {}
+  const String &name() const { return name_; }
+  const String &value() const { return value_; }
+
+private:
+  String name_;
+  String value_;
+};
+
+class AsyncWebServerResponse {
+public:
+  // The String overload copies the body, the byte overload sends from the caller's buffer
+  AsyncWebServerResponse(int code, const std::string &body) : code_(code), bytes_(body.size()), body_(body) {}
+  AsyncWebServerResponse(int code, const uint8_t *content, size_t len)
+      : code_(code), bytes_(len), content_(content), contentLength_(len) {}
+  void addHeader(const char *name, const String &value) {
+    bytes_ += strlen(name) + value.length() + 4;
+    headers_[name] = value.c_str();
+  }
+  int code() const { return code_; }
+  size_t bytes() const { return bytes_; }
+  std::string body() const {
+    return content_ ? std::string(reinterpret_cast<const char *>(content_), contentLength_) : body_;
+  }
+  std::string header(const char *name) const {
+    auto it = headers_.find(name);
+    return it == headers_.end() ? std::string() : it->second;
+  }
+
+private:
+  int code_;
+  size_t bytes_;
+  std::string body_;
+  const uint8_t *content_ = nullptr;
+  size_t contentLength_ = 0;
+  std::map<std::string, std::string> headers_;
+};
+
+class AsyncWebServerRequest {
+public:
+  AsyncWebServerRequest(WebRequestMethodComposite method, const std::map<std::string, std::string> &params,
+                        const std::map<std::string, std::string> &headers);
+
+  WebRequestMethodComposite method() const { return method_; }
+  bool hasParam(const char *name, bool post = false, bool file = false) const;
+  const AsyncWebParameter *getParam(const char *name, bool post = false, bool file = false) const;
+  bool hasHeader(const char *name) const { return headers_.count(name) != 0; }
+  String header(const char *name) const;
+
+  AsyncWebServerResponse *beginResponse(int code, const char *contentType = "", const String &content = String());
+  AsyncWebServerResponse *beginResponse(int code, const char *contentType, const uint8_t *content, size_t len);
+  void send(AsyncWebServerResponse *response);
+  void send(int code, const char *contentType = "", const String &content = String());
+  void redirect(const char *url);
+
+  // Host only: what the handler sent
+  int hostCode() const { return response_ ? response_->code() : 0; }
+  size_t hostBytes() const { return response_ ? response_->bytes() : 0; }
+  const AsyncWebServerResponse *hostResponse() const { return response_.get(); }
+
+private:
+  WebRequestMethodComposite method_;
+  std::vector<AsyncWebParameter> params_;
+  std::map<std::string, std::string> headers_;
+  std::unique_ptr<AsyncWebServerResponse> response_;
+};
+
+typedef std::function<void(AsyncWebServerRequest *request)> ArRequestHandlerFunction;
+
+class AsyncWebHandler {
+public:
+  virtual ~AsyncWebHandler() {}
+};
+
+// ---- WebSocket ----
+
+enum AwsEventType { WS_EVT_CONNECT, WS_EVT_DISCONNECT, WS_EVT_PONG, WS_EVT_ERROR, WS_EVT_DATA };
+enum AwsFrameType : uint8_t { WS_CONTINUATION = 0x00, WS_TEXT = 0x01, WS_BINARY = 0x02 };
+
+struct AwsFrameInfo {
+  uint8_t message_opcode;
+  uint32_t num;
+  uint8_t final;
+  uint8_t masked;
+  uint8_t opcode;
+  uint64_t len;
+  uint8_t mask[4];
+  uint64_t index;
+};
+
+class AsyncWebSocket;
+
+class AsyncWebSocketClient {
+public:
+  AsyncWebSocketClient(uint32_t id) : id_(id) {}
+  uint32_t id() const { return id_; }
+  void binary(const uint8_t *message, size_t len);
+  void close() { open_ = false; }
+
+  // Host only: what the board sent to this phone
+  bool hostOpen() const { return open_; }
+  size_t hostFrames() const { return frames_; }
+  size_t hostBytes() const { return bytes_; }
+  const std::vector<uint8_t> &hostLastFrame() const { return lastFrame_; }
+
+private:
+  uint32_t id_;
+  bool open_ = true;
+  size_t frames_ = 0;
+  size_t bytes_ = 0;
+  std::vector<uint8_t> lastFrame_;
+};
+
+typedef std::function<void(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType type, void *arg,
+                           uint8_t *data, size_t len)>
+    AwsEventHandler;
+
+class AsyncWebSocket : public AsyncWebHandler {
+public:
+  explicit AsyncWebSocket(const char *url) : url_(url) {}
+
+  const char *url() const { return url_.c_str(); }
+  void onEvent(AwsEventHandler handler) { handler_ = handler; }
+  size_t count() const;
+  void binary(uint32_t id, const uint8_t *message, size_t len);
+  void binaryAll(const uint8_t *message, size_t len);
+  bool availableForWriteAll() const { return writable_; }
+  void closeAll();
+  void cleanupClients(uint16_t maxClients = 8);
+
+  // Host only: a phone opens the socket / sends one binary frame / goes away
+  AsyncWebSocketClient *hostConnect();
+  void hostDisconnect(AsyncWebSocketClient *client);
+  void hostSend(AsyncWebSocketClient *client, const uint8_t *data, size_t len);
+  // Simulates a phone whose TCP window is full
+  void hostSetWritable(bool writable) { writable_ = writable; }
+
+private:
+  std::string url_;
+  AwsEventHandler handler_;
+  std::vector<std::unique_ptr<AsyncWebSocketClient>> clients_;
+  uint32_t nextId_ = 1;
+  bool writable_ = true;
+};
+
+class AsyncWebServer {
+public:
+  explicit AsyncWebServer(uint16_t port = 80);
+
+  void begin() { running_ = true; }
+  void end() { running_ = false; }
+  void reset() {
+    routes_.clear();
+    handlers_.clear();
+    notFound_ = nullptr;
+  }
+  void on(const char *uri, WebRequestMethodComposite method, ArRequestHandlerFunction handler) {
+    routes_.push_back({uri, method, handler});
+  }
+  void onNotFound(ArRequestHandlerFunction fn) { notFound_ = fn; }
+  void addHandler(AsyncWebHandler *handler) { handlers_.push_back(handler); }
+
+  // Host only: the most recently created server (the firmware keeps its own static)
+  static AsyncWebServer *hostInstance();
+  bool hostRunning() const { return running_; }
+  // The WebSocket added with addHandler() for url, or nullptr
+  AsyncWebSocket *hostSocket(const char *url) const;
+  // Runs the handler for uri with the given parameters and request headers;
+  // returns the status code (0 if the server isn't running)
+  int hostRequest(const char *uri, const std::map<std::string, std::string> &params = {},
+                  const std::map<std::string, std::string> &headers = {},
+                  WebRequestMethodComposite method = HTTP_GET);
+  size_t hostLastResponseBytes() const { return lastResponseBytes_; }
+  // Heap allocations made by the handler of the last request (heap model on)
+  uint32_t hostLastHandlerAllocations() const { return lastHandlerAllocations_; }
+  // Body and a header of the last response
+  const std::string &hostLastBody() const { return lastBody_; }
+  std::string hostLastHeader(const char *name) const { return lastResponse_.header(name); }
+
+private:
+  struct Route {
+    std::string uri;
+    WebRequestMethodComposite method;
+    ArRequestHandlerFunction handler;
+  };
+  uint16_t port_;
+  bool running_ = false;
+  std::vector<Route> routes_;
+  ArRequestHandlerFunction notFound_;
+  std::vector<AsyncWebHandler *> handlers_;
+  size_t lastResponseBytes_ = 0;
+  uint32_t lastHandlerAllocations_ = 0;
+  std::string lastBody_;
+  AsyncWebServerResponse lastResponse_{0, std::string()};
+};
+
+#endif // ESPASYNCWEBSERVER_H_HOST_SHIM
@@ -0,0 +1,76 @@
+// Host shim for the subset of FastLED used by the firmware.
+// The 8-bit math helpers follow FastLED's portable C implementations so
+// patterns produce the same frames as on the board.
+#ifndef FASTLED_H_HOST_SHIM
+#define FASTLED_H_HOST_SHIM
+
+#include <Arduino.h>
+
+struct CRGB {
+  union {
+    struct {
+      uint8_t r;
+      uint8_t g;
+      uint8_t b;
+    };
+    uint8_t raw[3];
+  };
+
+  enum HTMLColorCode {
+    Black = 0x000000,
+    Blue = 0x0000FF,
+    Green = 0x008000,
+    Red = 0xFF0000,
+    White = 0xFFFFFF,
+    Yellow = 0xFFFF00,
+    Yellow1 = 0xFFFF00
+  };
+
+  CRGB() : r(0), g(0), b(0) {}
+  CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+  CRGB(uint32_t colorcode) : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b(colorcode & 0xFF) {}
+  CRGB(HTMLColorCode colorcode) : CRGB((uint32_t)colorcode) {}
+
+  CRGB &nscale8(uint8_t scaledown) {
+    r = ((uint16_t)r * (1 + (uint16_t)scaledown)) >> 8;
+    g = ((uint16_t)g * (1 + (uint16_t)scaledown)) >> 8;
+    b = ((uint16_t)b * (1 + (uint16_t)scaledown)) >> 8;
+    return *this;
+  }
+
+  bool operator==(const CRGB &o) const { return r == o.r && g == o.g && b == o.b; }
+  bool operator!=(const CRGB &o) const { return !(*this == o); }
+};
+
+enum EOrder { RGB = 0012, GRB = 0102 };
+
+template <uint8_t DATA_PIN, EOrder RGB_ORDER> class WS2812B {};
+
+class CFastLED {
+public:
+  template <template <uint8_t, EOrder> class CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+  CFastLED &addLeds(CRGB *data, int nLeds) {
+    registerLeds(data, nLeds);
+    return *this;
+  }
+
+  void setBrightness(uint8_t scale) { brightness_ = scale; }
+  uint8_t getBrightness() const { return brightness_; }
+  void show() { show(brightness_); }
+  void show(uint8_t scale);
+
+private:
+  void registerLeds(CRGB *data, int nLeds);
+  uint8_t brightness_ = 255;
+};
+
+extern CFastLED FastLED;
+
+void fill_solid(CRGB *leds, int numToFill, const CRGB &color);
+CRGB blend(const CRGB &p1, const CRGB &p2, uint8_t amountOfP2);
+
+uint8_t random8();
+uint8_t random8(uint8_t lim);
+uint8_t sin8(uint8_t theta);
+
+#endif // FASTLED_H_HOST_SHIM
@@ -0,0 +1,896 @@
+// Host implementation of the Arduino/FastLED/ESP32 shim
+#include "HostShim.h"
+#include <Arduino.h>
+#include <FastLED.h>
+#include <Preferences.h>
+#include <WiFi.h>
+#include <ESPAsyncWebServer.h>
+#include <esp_partition.h>
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <sys/time.h>
+#include <map>
+#include <new>
+#include <vector>
+
+HardwareSerial Serial;
+EspClass ESP;
+CFastLED FastLED;
+WiFiClass WiFi;
+
+namespace {
+
+hostshim::Stats shimStats;
+uint64_t clockMicros = 0;
+uint64_t bootMicros = 0;    // clockMicros at the last deep sleep wake-up
+bool restartPending = false;
+uint64_t sleepLimitUs = 0;
+uint32_t cpuMhz = 160;
+bool serialEcho = false;
+uint16_t analogPins[32];
+uint16_t analogNoise[32];
+uint16_t analogDroop[32];
+uint32_t analogNoiseSeed = 12345;  // separate from random() so firmware sequences don't move
+uint32_t shownLoad = 0;            // sum of the shown channels, brightness applied
+bool digitalPins[32] = {
+  HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH,
+  HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH
+};
+const CRGB *ledData = nullptr;
+int ledLength = 0;
+bool shownLit = false;
+hostshim::ToneListener toneListener = nullptr;
+
+struct PinChange {
+  uint64_t atUs;
+  uint8_t pin;
+  bool level;
+};
+std::vector<PinChange> pinChanges; // sorted by time
+
+// Sleep configuration
+uint64_t timerWakeUs = 0;
+bool gpioWakeEnabled = false;
+uint32_t gpioWakeLowMask = 0;
+uint64_t deepSleepWakeLowMask = 0;
+esp_sleep_wakeup_cause_t wakeCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+
+// Data partitions the firmware opens; must match partitions.csv
+struct HostPartition {
+  esp_partition_t info;
+  std::vector<uint8_t> flash;
+};
+HostPartition hostPartitions[] = {
+  {{ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)0x40, 0x290000, 0x4000, SPI_FLASH_SEC_SIZE, "uptimelog", false}, {}},
+};
+
+HostPartition *findHostPartition(const esp_partition_t *partition) {
+  for (HostPartition &p : hostPartitions) {
+    if (&p.info == partition) {
+      if (p.flash.empty()) p.flash.assign(p.info.size, 0xFF);
+      return &p;
+    }
+  }
+  return nullptr;
+}
+
+// Heap model: blocks laid end to end in one arena, each with a header holding
+// its size (low bit set while in use) and the size of the block before it
+struct HeapBlock {
+  size_t size;
+  size_t prevSize;
+};
+const size_t HEAP_ALIGN = 16;
+const uint32_t HOST_NOMINAL_HEAP = 200000;  // reported while the model is off
+uint8_t *heapArena = nullptr;
+size_t heapArenaSize = 0;
+bool heapActive = false;
+hostshim::HeapStats heap;
+
+HeapBlock *heapBlockAt(size_t offset) { return reinterpret_cast<HeapBlock *>(heapArena + offset); }
+
+bool inHeapArena(const void *p) {
+  return heapArena && p >= heapArena && p < heapArena + heapArenaSize;
+}
+
+void *heapModelAlloc(size_t bytes) {
+  size_t need = (bytes + sizeof(HeapBlock) + HEAP_ALIGN - 1) & ~(HEAP_ALIGN - 1);
+  for (size_t offset = 0; offset < heapArenaSize;) {
+    HeapBlock *block = heapBlockAt(offset);
+    size_t size = block->size & ~(size_t)1;
+    if (!(block->size & 1) && size >= need) {
+      if (size - need >= sizeof(HeapBlock) + HEAP_ALIGN) {
+        HeapBlock *rest = heapBlockAt(offset + need);
+        rest->size = size - need;
+        rest->prevSize = need;
+        if (offset + size < heapArenaSize) heapBlockAt(offset + size)->prevSize = size - need;
+        size = need;
+      }
+      block->size = size | 1;
+      heap.freeBytes -= size;
+      if (heap.freeBytes < heap.minFreeBytes) heap.minFreeBytes = heap.freeBytes;
+      heap.allocations++;
+      heap.liveBlocks++;
+      return block + 1;
+    }
+    offset += size;
+  }
+  heap.failed++;
+  return nullptr;
+}
+
+void heapModelFree(void *p) {
+  HeapBlock *block = static_cast<HeapBlock *>(p) - 1;
+  size_t offset = reinterpret_cast<uint8_t *>(block) - heapArena;
+  size_t size = block->size & ~(size_t)1;
+  heap.freeBytes += size;
+  heap.liveBlocks--;
+
+  // Coalesce with free neighbours
+  if (offset + size < heapArenaSize && !(heapBlockAt(offset + size)->size & 1)) {
+    size += heapBlockAt(offset + size)->size;
+  }
+  if (offset > 0 && !(heapBlockAt(offset - block->prevSize)->size & 1)) {
+    offset -= block->prevSize;
+    size += heapBlockAt(offset)->size;
+    block = heapBlockAt(offset);
+  }
+  block->size = size;
+  if (offset + size < heapArenaSize) heapBlockAt(offset + size)->prevSize = size;
+}
+
+} // namespace
+
+void *operator new(size_t size) {
+  if (heapActive) {
+    void *p = heapModelAlloc(size);
+    if (p) return p;
+  }
+  void *p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void *p) noexcept {
+  if (inHeapArena(p)) {
+    heapModelFree(p);
+  } else {
+    free(p);
+  }
+}
+
+void operator delete[](void *p) noexcept { operator delete(p); }
+void operator delete(void *p, size_t) noexcept { operator delete(p); }
+void operator delete[](void *p, size_t) noexcept { operator delete(p); }
+
+struct esp_timer {
+  esp_timer_cb_t callback;
+  void *arg;
+  uint64_t dueUs;
+  bool armed;
+};
+
+namespace {
+
+std::vector<esp_timer *> timers;
+
+// Earliest armed esp_timer due at or before 'to'
+esp_timer *nextTimer(uint64_t to) {
+  esp_timer *next = nullptr;
+  for (esp_timer *timer : timers) {
+    if (timer->armed && timer->dueUs <= to && (!next || timer->dueUs < next->dueUs)) next = timer;
+  }
+  return next;
+}
+
+// Moves the clock to 'to', applying queued pin changes and firing timers on the way
+void runClockTo(uint64_t to) {
+  for (;;) {
+    esp_timer *timer = nextTimer(to);
+    const bool pinFirst = !pinChanges.empty() && pinChanges.front().atUs <= to &&
+                          (!timer || pinChanges.front().atUs <= timer->dueUs);
+    if (pinFirst) {
+      if (pinChanges.front().atUs > clockMicros) clockMicros = pinChanges.front().atUs;
+      digitalPins[pinChanges.front().pin & 31] = pinChanges.front().level;
+      pinChanges.erase(pinChanges.begin());
+    } else if (timer) {
+      if (timer->dueUs > clockMicros) clockMicros = timer->dueUs;
+      timer->armed = false;
+      timer->callback(timer->arg);
+    } else {
+      break;
+    }
+  }
+  if (to > clockMicros) clockMicros = to;
+}
+
+bool gpioWakeAsserted(uint64_t lowMask) {
+  for (uint8_t pin = 0; pin < 32; pin++) {
+    if ((lowMask & (1ull << pin)) && digitalPins[pin] == LOW) return true;
+  }
+  return false;
+}
+
+// Runs the clock until a timer wake-up (0 = none) or a LOW on a pin in
+// lowMask, whichever comes first; false if it was the timer
+bool sleepUntilWake(uint64_t timerWake, uint64_t lowMask) {
+  const uint64_t timerEnd = timerWake ? clockMicros + timerWake : UINT64_MAX;
+  if (gpioWakeAsserted(lowMask)) return true;
+  while (!pinChanges.empty() && pinChanges.front().atUs <= timerEnd) {
+    runClockTo(pinChanges.front().atUs);
+    if (gpioWakeAsserted(lowMask)) return true;
+  }
+  // Nothing would ever wake the chip: stop at the sleep limit instead of hanging
+  runClockTo(timerEnd != UINT64_MAX ? timerEnd : sleepLimitUs > clockMicros ? sleepLimitUs : clockMicros);
+  return false;
+}
+
+// Backing store for Preferences: namespace -> key -> bytes
+std::map<std::string, std::map<std::string, std::vector<uint8_t>>> nvs;
+
+// Arduino random() on the ESP32 is backed by esp_random(); any decent PRNG will do here
+uint32_t arduinoSeed = 1;
+uint16_t rand16seed = 1337;
+
+} // namespace
+
+namespace hostshim {
+
+Stats &stats() { return shimStats; }
+void resetStats() { shimStats = Stats(); }
+
+uint64_t nowMicros() { return clockMicros; }
+void advanceMicros(uint64_t us) { runClockTo(clockMicros + us); }
+void advanceMillis(uint32_t ms) { runClockTo(clockMicros + (uint64_t)ms * 1000); }
+
+bool takeRestart() {
+  bool pending = restartPending;
+  restartPending = false;
+  return pending;
+}
+
+void setSleepLimit(uint64_t atUs) { sleepLimitUs = atUs; }
+
+void setAnalogPin(uint8_t pin, uint16_t value) { analogPins[pin & 31] = value; }
+
+void setAnalogNoise(uint8_t pin, uint16_t noise, uint16_t droop) {
+  analogNoise[pin & 31] = noise;
+  analogDroop[pin & 31] = droop;
+}
+void setDigitalPin(uint8_t pin, bool level) { digitalPins[pin & 31] = level; }
+
+void scheduleDigitalPin(uint64_t atUs, uint8_t pin, bool level) {
+  PinChange change = {atUs, pin, level};
+  auto it = pinChanges.begin();
+  while (it != pinChanges.end() && it->atUs <= atUs) ++it;
+  pinChanges.insert(it, change);
+}
+void setSerialEcho(bool enabled) { serialEcho = enabled; }
+void setToneListener(ToneListener listener) { toneListener = listener; }
+
+const uint8_t *ledFrame() { return ledData ? ledData->raw : nullptr; }
+int ledCount() { return ledLength; }
+bool lastShowLit() { return shownLit; }
+
+void erasePartitions() {
+  for (HostPartition &p : hostPartitions) p.flash.clear();
+}
+
+void heapModelBegin(size_t bytes) {
+  heapModelEnd();
+  // Blocks still living in an earlier arena keep it; a new one is only
+  // allocated when that one is empty
+  if (heapArena && heap.liveBlocks == 0) {
+    free(heapArena);
+    heapArena = nullptr;
+  }
+  if (heapArena) {
+    heapActive = true;
+    return;
+  }
+  heapArenaSize = bytes & ~(HEAP_ALIGN - 1);
+  heapArena = static_cast<uint8_t *>(malloc(heapArenaSize));
+  heap = HeapStats();
+  heap.size = heapArenaSize;
+  heap.freeBytes = heapArenaSize;
+  heap.minFreeBytes = heapArenaSize;
+  heapBlockAt(0)->size = heapArenaSize;
+  heapBlockAt(0)->prevSize = 0;
+  heapActive = true;
+}
+
+void heapModelEnd() { heapActive = false; }
+
+HeapStats heapStats() {
+  heap.largestFree = 0;
+  for (size_t offset = 0; offset < heapArenaSize;) {
+    size_t size = heapBlockAt(offset)->size;
+    if (!(size & 1) && size - sizeof(HeapBlock) > heap.largestFree) heap.largestFree = size - sizeof(HeapBlock);
+    offset += size & ~(size_t)1;
+  }
+  return heap;
+}
+
+HeapModelPause::HeapModelPause() : wasActive_(heapActive) { heapActive = false; }
+HeapModelPause::~HeapModelPause() { heapActive = wasActive_; }
+
+} // namespace hostshim
+
+// ---- Arduino core ----
+
+uint32_t millis() { return (uint32_t)((clockMicros - bootMicros) / 1000); }
+uint32_t micros() { return (uint32_t)(clockMicros - bootMicros); }
+void delay(uint32_t ms) {
+  shimStats.delayUs += (uint64_t)ms * 1000;
+  hostshim::advanceMillis(ms);
+}
+
+void delayMicroseconds(uint32_t us) {
+  shimStats.delayUs += us;
+  hostshim::advanceMicros(us);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+int digitalRead(uint8_t pin) { shimStats.digitalReads++; return digitalPins[pin & 31]; }
+void digitalWrite(uint8_t pin, uint8_t val) { digitalPins[pin & 31] = val; }
+uint16_t analogRead(uint8_t pin) {
+  pin &= 31;
+  shimStats.analogReads++;
+  int32_t value = analogPins[pin];
+  if (analogDroop[pin] && ledLength) value -= (int64_t)analogDroop[pin] * shownLoad / (ledLength * 3 * 255);
+  if (analogNoise[pin]) {
+    analogNoiseSeed = analogNoiseSeed * 1664525u + 1013904223u;
+    value += (int32_t)((analogNoiseSeed >> 8) % (2u * analogNoise[pin] + 1)) - analogNoise[pin];
+  }
+  return (uint16_t)constrain(value, 0, 4095);
+}
+
+uint32_t analogReadMilliVolts(uint8_t pin) { return (analogRead(pin) * 3300u + 2047) / 4095; }
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration) {
+  shimStats.tones++;
+  if (cpuMhz < 80) shimStats.slowClockOutputs++;
+  if (toneListener) toneListener(clockMicros, pin, frequency, duration);
+}
+
+void noTone(uint8_t pin) {
+  shimStats.noTones++;
+  if (toneListener) toneListener(clockMicros, pin, 0, 0);
+}
+
+static uint32_t nextArduinoRandom() {
+  // xorshift32
+  arduinoSeed ^= arduinoSeed << 13;
+  arduinoSeed ^= arduinoSeed >> 17;
+  arduinoSeed ^= arduinoSeed << 5;
+  return arduinoSeed;
+}
+
+long random(long howbig) {
+  if (howbig <= 0) return 0;
+  return nextArduinoRandom() % howbig;
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) return howsmall;
+  return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) arduinoSeed = (uint32_t)seed;
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  const long dividend = out_max - out_min;
+  const long divisor = in_max - in_min;
+  const long delta = x - in_min;
+  if (divisor == 0) return -1;
+  return (delta * dividend + (divisor / 2)) / divisor + out_min;
+}
+
+bool setCpuFrequencyMhz(uint32_t cpu_freq_mhz) {
+  if (cpu_freq_mhz != 160 && cpu_freq_mhz != 80 && cpu_freq_mhz != 40 && cpu_freq_mhz != 20 && cpu_freq_mhz != 10) {
+    return false;
+  }
+  if (cpu_freq_mhz != cpuMhz) shimStats.cpuClockChanges++;
+  cpuMhz = cpu_freq_mhz;
+  return true;
+}
+
+uint32_t getCpuFrequencyMhz() { return cpuMhz; }
+
+// ---- Power management ----
+
+esp_err_t esp_pm_configure(const void *config) { return ESP_ERR_NOT_SUPPORTED; }
+esp_err_t esp_pm_lock_create(esp_pm_lock_type_t lock_type, int arg, const char *name, esp_pm_lock_handle_t *out_handle) {
+  return ESP_ERR_NOT_SUPPORTED;
+}
+esp_err_t esp_pm_lock_acquire(esp_pm_lock_handle_t handle) { return ESP_ERR_NOT_SUPPORTED; }
+esp_err_t esp_pm_lock_release(esp_pm_lock_handle_t handle) { return ESP_ERR_NOT_SUPPORTED; }
+
+// ---- Sleep ----
+
+esp_err_t gpio_wakeup_enable(gpio_num_t gpio_num, gpio_int_type_t intr_type) {
+  if (intr_type == GPIO_INTR_LOW_LEVEL) gpioWakeLowMask |= 1u << (gpio_num & 31);
+  return ESP_OK;
+}
+
+esp_err_t gpio_wakeup_disable(gpio_num_t gpio_num) {
+  gpioWakeLowMask &= ~(1u << (gpio_num & 31));
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us) {
+  timerWakeUs = time_in_us;
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_gpio_wakeup(void) {
+  gpioWakeEnabled = true;
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t source) {
+  if (source == ESP_SLEEP_WAKEUP_TIMER || source == ESP_SLEEP_WAKEUP_ALL) timerWakeUs = 0;
+  if (source == ESP_SLEEP_WAKEUP_GPIO || source == ESP_SLEEP_WAKEUP_ALL) gpioWakeEnabled = false;
+  return ESP_OK;
+}
+
+esp_err_t esp_light_sleep_start(void) {
+  const uint64_t start = clockMicros;
+  const bool gpio = sleepUntilWake(timerWakeUs, gpioWakeEnabled ? gpioWakeLowMask : 0);
+  wakeCause = gpio ? ESP_SLEEP_WAKEUP_GPIO : ESP_SLEEP_WAKEUP_TIMER;
+
+  shimStats.lightSleeps++;
+  shimStats.lightSleepUs += clockMicros - start;
+  return ESP_OK;
+}
+
+esp_err_t esp_deep_sleep_enable_gpio_wakeup(uint64_t gpio_pin_mask, esp_deepsleep_gpio_wake_up_mode_t mode) {
+  if (mode == ESP_GPIO_WAKEUP_GPIO_LOW) deepSleepWakeLowMask |= gpio_pin_mask;
+  return ESP_OK;
+}
+
+void esp_deep_sleep_start(void) {
+  // RAM, timers and wake-up sources are lost; only the clock (the RTC timer) goes on
+  for (esp_timer *timer : timers) timer->armed = false;
+  const uint64_t start = clockMicros;
+  const bool gpio = sleepUntilWake(timerWakeUs, deepSleepWakeLowMask);
+  wakeCause = gpio ? ESP_SLEEP_WAKEUP_GPIO : ESP_SLEEP_WAKEUP_TIMER;
+  timerWakeUs = 0;
+  gpioWakeEnabled = false;
+  gpioWakeLowMask = 0;
+  deepSleepWakeLowMask = 0;
+
+  shimStats.deepSleeps++;
+  shimStats.deepSleepUs += clockMicros - start;
+  bootMicros = clockMicros;
+  cpuMhz = 160;  // board_build.f_cpu
+  restartPending = true;
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void) { return wakeCause; }
+
+// Pads hold their level through deep sleep; nothing to model on the host
+esp_err_t gpio_hold_en(gpio_num_t gpio_num) { return ESP_OK; }
+esp_err_t gpio_hold_dis(gpio_num_t gpio_num) { return ESP_OK; }
+void gpio_deep_sleep_hold_en(void) {}
+
+// The RTC clock, which deep sleep doesn't stop. Replaces the C library's
+// gettimeofday() for the whole host program.
+extern "C" int gettimeofday(struct timeval *__restrict tv, void *__restrict tz) noexcept {
+  tv->tv_sec = (time_t)(clockMicros / 1000000);
+  tv->tv_usec = (suseconds_t)(clockMicros % 1000000);
+  return 0;
+}
+
+// ---- esp_timer ----
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle) {
+  esp_timer *timer = new esp_timer{create_args->callback, create_args->arg, 0, false};
+  timers.push_back(timer);
+  *out_handle = timer;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+  timer->dueUs = clockMicros + timeout_us;
+  timer->armed = true;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+  timer->armed = false;
+  return ESP_OK;
+}
+
+int64_t esp_timer_get_time(void) { return (int64_t)(clockMicros - bootMicros); }
+
+// ---- Serial ----
+
+void HardwareSerial::print(const char *s) {
+  if (serialEcho) fputs(s, stdout);
+}
+
+void HardwareSerial::print(char c) {
+  if (serialEcho) fputc(c, stdout);
+}
+
+void HardwareSerial::print(int v) { if (serialEcho) printf("%d", v); }
+void HardwareSerial::print(unsigned int v) { if (serialEcho) printf("%u", v); }
+void HardwareSerial::print(long v) { if (serialEcho) printf("%ld", v); }
+void HardwareSerial::print(unsigned long v) { if (serialEcho) printf("%lu", v); }
+void HardwareSerial::print(double v, int digits) { if (serialEcho) printf("%.*f", digits, v); }
+void HardwareSerial::print(const IPAddress &ip) { print(ip.toString()); }
+
+int HardwareSerial::printf(const char *fmt, ...) {
+  if (!serialEcho) return 0;
+  va_list args;
+  va_start(args, fmt);
+  int n = vprintf(fmt, args);
+  va_end(args);
+  return n;
+}
+
+// ---- FastLED ----
+
+void CFastLED::registerLeds(CRGB *data, int nLeds) {
+  ledData = data;
+  ledLength = nLeds;
+}
+
+void CFastLED::show(uint8_t scale) {
+  shimStats.ledShows++;
+  if (cpuMhz < 80) shimStats.slowClockOutputs++;
+  shownLit = false;
+  shownLoad = 0;
+  if (scale == 0 || !ledData) return;
+  for (int i = 0; i < ledLength; i++) {
+    shownLit |= ledData[i].r || ledData[i].g || ledData[i].b;
+    shownLoad += (uint32_t)(ledData[i].r + ledData[i].g + ledData[i].b) * scale / 255;
+  }
+}
+
+void fill_solid(CRGB *leds, int numToFill, const CRGB &color) {
+  for (int i = 0; i < numToFill; i++) {
+    leds[i] = color;
+  }
+}
+
+static uint8_t blend8(uint8_t a, uint8_t b, uint8_t amountOfB) {
+  uint16_t partial = (a << 8) | b;
+  partial -= (a * amountOfB);
+  partial += (b * amountOfB);
+  return partial >> 8;
+}
+
+CRGB blend(const CRGB &p1, const CRGB &p2, uint8_t amountOfP2) {
+  return CRGB(blend8(p1.r, p2.r, amountOfP2), blend8(p1.g, p2.g, amountOfP2), blend8(p1.b, p2.b, amountOfP2));
+}
+
+uint8_t random8() {
+  rand16seed = (rand16seed * 2053) + 13849;
+  return (uint8_t)(((uint8_t)(rand16seed & 0xFF)) + ((uint8_t)(rand16seed >> 8)));
+}
+
+uint8_t random8(uint8_t lim) {
+  return (uint8_t)((random8() * lim) >> 8);
+}
+
+uint8_t sin8(uint8_t theta) {
+  static const uint8_t b_m16_interleave[] = { 0, 49, 49, 41, 90, 27, 117, 10 };
+  uint8_t offset = theta;
+  if (theta & 0x40) {
+    offset = (uint8_t)255 - offset;
+  }
+  offset &= 0x3F;
+
+  uint8_t secoffset = offset & 0x0F;
+  if (theta & 0x40) ++secoffset;
+
+  uint8_t section = offset >> 4;
+  const uint8_t *p = b_m16_interleave + section * 2;
+  uint8_t b = p[0];
+  uint8_t m16 = p[1];
+  uint8_t mx = (m16 * secoffset) >> 4;
+
+  int8_t y = mx + b;
+  if (theta & 0x80) y = -y;
+  y += 128;
+  return y;
+}
+
+// ---- Preferences ----
+
+bool Preferences::begin(const char *name, bool readOnly, const char *partition_label) {
+  (void)partition_label;
+  namespace_ = name;
+  readOnly_ = readOnly;
+  open_ = true;
+  if (!readOnly) shimStats.nvsSessions++;
+  return true;
+}
+
+void Preferences::end() { open_ = false; }
+
+bool Preferences::clear() {
+  if (!open_ || readOnly_) return false;
+  nvs[namespace_].clear();
+  return true;
+}
+
+bool Preferences::remove(const char *key) {
+  if (!open_ || readOnly_) return false;
+  return nvs[namespace_].erase(key) != 0;
+}
+
+bool Preferences::isKey(const char *key) {
+  return open_ && nvs[namespace_].count(key) != 0;
+}
+
+size_t Preferences::getBytesLength(const char *key) {
+  if (!open_) return 0;
+  auto &ns = nvs[namespace_];
+  auto it = ns.find(key);
+  return it == ns.end() ? 0 : it->second.size();
+}
+
+size_t Preferences::putRaw(const char *key, const void *value, size_t len) {
+  if (!open_ || readOnly_) return 0;
+  const uint8_t *bytes = static_cast<const uint8_t *>(value);
+  std::vector<uint8_t> &slot = nvs[namespace_][key];
+  shimStats.nvsWrites++;
+  shimStats.nvsBytesWritten += len;
+  if (slot.size() != len || memcmp(slot.data(), bytes, len) != 0) {
+    shimStats.nvsChangedWrites++;
+    slot.assign(bytes, bytes + len);
+  }
+  return len;
+}
+
+size_t Preferences::getRaw(const char *key, void *buf, size_t len) {
+  if (!open_) return 0;
+  auto &ns = nvs[namespace_];
+  auto it = ns.find(key);
+  if (it == ns.end() || it->second.size() > len) return 0;
+  memcpy(buf, it->second.data(), it->second.size());
+  return it->second.size();
+}
+
+// ---- Partitions ----
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char *label) {
+  for (HostPartition &p : hostPartitions) {
+    if (p.info.type != type) continue;
+    if (subtype != ESP_PARTITION_SUBTYPE_ANY && p.info.subtype != subtype) continue;
+    if (label && strcmp(label, p.info.label) != 0) continue;
+    return &p.info;
+  }
+  return nullptr;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size) {
+  HostPartition *p = findHostPartition(partition);
+  if (!p) return ESP_ERR_INVALID_ARG;
+  if (src_offset + size > p->info.size) return ESP_ERR_INVALID_SIZE;
+  memcpy(dst, p->flash.data() + src_offset, size);
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset, const void *src, size_t size) {
+  HostPartition *p = findHostPartition(partition);
+  if (!p) return ESP_ERR_INVALID_ARG;
+  if (dst_offset + size > p->info.size) return ESP_ERR_INVALID_SIZE;
+  const uint8_t *bytes = static_cast<const uint8_t *>(src);
+  for (size_t i = 0; i < size; i++) p->flash[dst_offset + i] &= bytes[i];
+  shimStats.partitionBytesWritten += size;
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size) {
+  HostPartition *p = findHostPartition(partition);
+  if (!p) return ESP_ERR_INVALID_ARG;
+  if (offset % SPI_FLASH_SEC_SIZE || size % SPI_FLASH_SEC_SIZE || offset + size > p->info.size) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  memset(p->flash.data() + offset, 0xFF, size);
+  shimStats.partitionErases += size / SPI_FLASH_SEC_SIZE;
+  return ESP_OK;
+}
+
+// ---- ESP ----
+
+uint32_t EspClass::getHeapSize() { return heapArena ? heapArenaSize : HOST_NOMINAL_HEAP; }
+uint32_t EspClass::getFreeHeap() { return heapArena ? heap.freeBytes : HOST_NOMINAL_HEAP; }
+uint32_t EspClass::getMinFreeHeap() { return heapArena ? heap.minFreeBytes : HOST_NOMINAL_HEAP; }
+uint32_t EspClass::getMaxAllocHeap() { return heapArena ? hostshim::heapStats().largestFree : HOST_NOMINAL_HEAP; }
+
+// ---- WiFi ----
+
+String IPAddress::toString() const {
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%u.%u.%u.%u", bytes_[0], bytes_[1], bytes_[2], bytes_[3]);
+  return String(buf);
+}
+
+void WiFiClass::onEvent(WiFiEventFuncCb cb, arduino_event_id_t event) {
+  if (event == ARDUINO_EVENT_WIFI_AP_STACONNECTED) connected_ = cb;
+  if (event == ARDUINO_EVENT_WIFI_AP_STADISCONNECTED) disconnected_ = cb;
+}
+
+void WiFiClass::hostSetStations(uint8_t n) {
+  WiFiEventInfo_t info = {};
+  while (stations_ < n) {
+    stations_++;
+    if (connected_) connected_(ARDUINO_EVENT_WIFI_AP_STACONNECTED, info);
+  }
+  while (stations_ > n) {
+    stations_--;
+    if (disconnected_) disconnected_(ARDUINO_EVENT_WIFI_AP_STADISCONNECTED, info);
+  }
+}
+
+// ---- ESPAsyncWebServer ----
+
+AsyncWebServerRequest::AsyncWebServerRequest(WebRequestMethodComposite method,
+                                             const std::map<std::string, std::string> &params,
+                                             const std::map<std::string, std::string> &headers)
+    : method_(method), headers_(headers) {
+  for (const auto &param : params) params_.emplace_back(String(param.first), String(param.second));
+}
+
+bool AsyncWebServerRequest::hasParam(const char *name, bool post, bool file) const {
+  return getParam(name, post, file) != nullptr;
+}
+
+const AsyncWebParameter *AsyncWebServerRequest::getParam(const char *name, bool post, bool file) const {
+  (void)post;
+  (void)file;
+  for (const AsyncWebParameter &param : params_) {
+    if (param.name() == name) return &param;
+  }
+  return nullptr;
+}
+
+String AsyncWebServerRequest::header(const char *name) const {
+  auto it = headers_.find(name);
+  return it == headers_.end() ? String() : String(it->second);
+}
+
+AsyncWebServerResponse *AsyncWebServerRequest::beginResponse(int code, const char *contentType, const String &content) {
+  (void)contentType;
+  return new AsyncWebServerResponse(code, std::string(content.c_str(), content.length()));
+}
+
+AsyncWebServerResponse *AsyncWebServerRequest::beginResponse(int code, const char *contentType, const uint8_t *content,
+                                                             size_t len) {
+  (void)contentType;
+  return new AsyncWebServerResponse(code, content, len);
+}
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse *response) {
+  response_.reset(response);
+}
+
+void AsyncWebServerRequest::send(int code, const char *contentType, const String &content) {
+  send(beginResponse(code, contentType, content));
+}
+
+void AsyncWebServerRequest::redirect(const char *url) {
+  AsyncWebServerResponse *response = beginResponse(302);
+  response->addHeader("Location", url);
+  send(response);
+}
+
+void AsyncWebSocketClient::binary(const uint8_t *message, size_t len) {
+  if (!open_) return;
+  frames_++;
+  bytes_ += len + 2;  // plus the frame header
+  lastFrame_.assign(message, message + len);
+}
+
+size_t AsyncWebSocket::count() const {
+  size_t n = 0;
+  for (const auto &client : clients_) n += client->hostOpen();
+  return n;
+}
+
+void AsyncWebSocket::binary(uint32_t id, const uint8_t *message, size_t len) {
+  for (const auto &client : clients_) {
+    if (client->id() == id) client->binary(message, len);
+  }
+}
+
+void AsyncWebSocket::binaryAll(const uint8_t *message, size_t len) {
+  for (const auto &client : clients_) client->binary(message, len);
+}
+
+void AsyncWebSocket::closeAll() {
+  for (const auto &client : clients_) hostDisconnect(client.get());
+}
+
+void AsyncWebSocket::hostDisconnect(AsyncWebSocketClient *client) {
+  if (!client->hostOpen()) return;
+  client->close();
+  if (handler_) handler_(this, client, WS_EVT_DISCONNECT, nullptr, nullptr, 0);
+}
+
+// Closed clients stay allocated so host tools can keep reading their counters
+void AsyncWebSocket::cleanupClients(uint16_t maxClients) {
+  (void)maxClients;
+}
+
+AsyncWebSocketClient *AsyncWebSocket::hostConnect() {
+  clients_.emplace_back(new AsyncWebSocketClient(nextId_++));
+  AsyncWebSocketClient *client = clients_.back().get();
+  if (handler_) handler_(this, client, WS_EVT_CONNECT, nullptr, nullptr, 0);
+  return client;
+}
+
+void AsyncWebSocket::hostSend(AsyncWebSocketClient *client, const uint8_t *data, size_t len) {
+  if (!client->hostOpen() || !handler_) return;
+  AwsFrameInfo info = {};
+  info.message_opcode = WS_BINARY;
+  info.opcode = WS_BINARY;
+  info.final = 1;
+  info.len = len;
+  std::vector<uint8_t> copy(data, data + len);
+  handler_(this, client, WS_EVT_DATA, &info, copy.data(), len);
+}
+
+static AsyncWebServer *lastAsyncServer = nullptr;
+
+AsyncWebServer::AsyncWebServer(uint16_t port) : port_(port) {
+  lastAsyncServer = this;
+}
+
+AsyncWebServer *AsyncWebServer::hostInstance() {
+  return lastAsyncServer;
+}
+
+AsyncWebSocket *AsyncWebServer::hostSocket(const char *url) const {
+  for (AsyncWebHandler *handler : handlers_) {
+    AsyncWebSocket *socket = dynamic_cast<AsyncWebSocket *>(handler);
+    if (socket && strcmp(socket->url(), url) == 0) return socket;
+  }
+  return nullptr;
+}
+
+int AsyncWebServer::hostRequest(const char *uri, const std::map<std::string, std::string> &params,
+                                const std::map<std::string, std::string> &headers,
+                                WebRequestMethodComposite method) {
+  {
+    hostshim::HeapModelPause pause;
+    lastResponseBytes_ = 0;
+    lastHandlerAllocations_ = 0;
+    lastBody_.clear();
+    lastResponse_ = AsyncWebServerResponse(0, std::string());
+  }
+  if (!running_) return 0;
+
+  AsyncWebServerRequest request(method, params, headers);
+  ArRequestHandlerFunction handler = notFound_;
+  for (const Route &route : routes_) {
+    if (route.uri == uri && (route.method & method)) {
+      handler = route.handler;
+      break;
+    }
+  }
+  uint32_t allocations = hostshim::heapStats().allocations;
+  if (handler) handler(&request);
+  lastHandlerAllocations_ = hostshim::heapStats().allocations - allocations;
+
+  hostshim::HeapModelPause pause;
+  lastResponseBytes_ = request.hostBytes();
+  if (request.hostResponse()) {
+    lastResponse_ = *request.hostResponse();
+    lastBody_ = lastResponse_.body();
+  }
+  return request.hostCode();
+}
@@ -0,0 +1,112 @@
+// Host-side control of the Arduino shim.
+// The firmware never includes this file; the host tools (benchmark, simulator)
+// use it to drive the clock, script the pins and read back what the firmware did.
+#ifndef HOST_SHIM_H
+#define HOST_SHIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace hostshim {
+
+// Counters for everything that costs power or flash wear on the real board
+struct Stats {
+  uint32_t ledShows;
+  uint32_t tones;
+  uint32_t noTones;
+  uint32_t nvsSessions;      // preferences.begin() in read/write mode
+  uint32_t nvsWrites;        // put*() calls
+  uint32_t nvsChangedWrites; // put*() calls that changed the stored value
+  uint32_t nvsBytesWritten;
+  uint32_t partitionBytesWritten;  // esp_partition_write() outside NVS
+  uint32_t partitionErases;        // sectors
+  uint32_t analogReads;
+  uint32_t digitalReads;
+  uint64_t delayUs;          // time spent in delay()
+  uint64_t lightSleepUs;     // time spent in esp_light_sleep_start()
+  uint32_t lightSleeps;
+  uint64_t deepSleepUs;      // time spent in esp_deep_sleep_start()
+  uint32_t deepSleeps;
+  uint32_t cpuClockChanges;  // setCpuFrequencyMhz() calls that changed the clock
+  uint32_t slowClockOutputs; // FastLED.show()/tone() below 80 MHz, where the APB clock is too slow
+};
+
+Stats& stats();
+void resetStats();
+
+// Clock: millis()/micros() are derived from a 64-bit microsecond counter.
+// delay() never sleeps on the host, it advances the clock instead. nowMicros()
+// keeps counting through deep sleep, like the RTC timer behind gettimeofday();
+// millis(), micros() and esp_timer_get_time() start from 0 at every wake-up.
+uint64_t nowMicros();
+void advanceMicros(uint64_t us);
+void advanceMillis(uint32_t ms);
+
+// Pins: analogRead()/digitalRead() return these values
+void setAnalogPin(uint8_t pin, uint16_t value);
+void setDigitalPin(uint8_t pin, bool level);
+
+// ADC realism: every read of the pin adds uniform noise of +-noise counts and
+// sags by up to droop counts with the LED load of the last FastLED.show()
+void setAnalogNoise(uint8_t pin, uint16_t noise, uint16_t droop);
+
+// Queues a digital level change at an absolute clock time. It is applied as
+// the clock passes it, and ends a light sleep if the pin is a wake-up source.
+void scheduleDigitalPin(uint64_t atUs, uint8_t pin, bool level);
+
+// Buzzer: called for every tone()/noTone() (noTone reports frequency 0, duration 0)
+typedef void (*ToneListener)(uint64_t atUs, uint8_t pin, unsigned int frequency, unsigned long durationMs);
+void setToneListener(ToneListener listener);
+
+// True once after esp_deep_sleep_start() woke the board: its RAM is gone and
+// the tool should call setup() again. Globals keep their values on the host.
+bool takeRestart();
+
+// Where a sleep that nothing would ever wake ends (e.g. the end of a sim run);
+// by default it ends at once
+void setSleepLimit(uint64_t atUs);
+
+// Serial output is muted by default so it doesn't distort timings
+void setSerialEcho(bool enabled);
+
+// Frame currently registered with FastLED.addLeds()
+const uint8_t* ledFrame();
+int ledCount();
+
+// True if the last FastLED.show() pushed at least one non-black pixel
+bool lastShowLit();
+
+// Partitions: drops the contents of every data partition (a fresh board)
+void erasePartitions();
+
+// Heap model: between heapModelBegin() and heapModelEnd() every operator new is
+// served first-fit from an arena of the given size, so fragmentation builds up
+// the way it does in the board's heap. ESP.getFreeHeap()/getMaxAllocHeap()
+// report the arena.
+struct HeapStats {
+  size_t size;
+  size_t freeBytes;
+  size_t minFreeBytes;    // low-water mark
+  size_t largestFree;     // biggest allocation that would still succeed
+  uint32_t allocations;   // since heapModelBegin()
+  uint32_t liveBlocks;
+  uint32_t failed;        // didn't fit: a crash or reset on the board
+};
+
+void heapModelBegin(size_t bytes);
+void heapModelEnd();
+HeapStats heapStats();
+
+// Keeps host-only bookkeeping out of the heap model while in scope
+class HeapModelPause {
+public:
+  HeapModelPause();
+  ~HeapModelPause();
+
+private:
+  bool wasActive_;
+};
+
+} // namespace hostshim
+
+#endif // HOST_SHIM_H
@@ -0,0 +1,18 @@
+// Commands of the host program, one per file (host_*.cpp)
+#ifndef HOST_TOOLS_H
+#define HOST_TOOLS_H
+
+#include <stdint.h>
+
+int benchMain(int argc, char **argv);
+int simMain(int argc, char **argv);
+int renderMain(int argc, char **argv);
+int heapBenchMain(int argc, char **argv);
+
+// Board pins the host tools poke at (must match src/main.cpp)
+const uint8_t HOST_PIN_BATT_SENSE = 0;
+const uint8_t HOST_PIN_BUTTON1 = 4;
+const uint8_t HOST_PIN_BUTTON2 = 5;
+const uint8_t HOST_PIN_BUZZER = 10;
+
+#endif // HOST_TOOLS_H
@@ -0,0 +1,37 @@
+// Host shim for the ESP32 Preferences (NVS) library.
+// Values live in memory; every write is counted in hostshim::stats().
+#ifndef PREFERENCES_H_HOST_SHIM
+#define PREFERENCES_H_HOST_SHIM
+
+#include <Arduino.h>
+
+class Preferences {
+public:
+  bool begin(const char *name, bool readOnly = false, const char *partition_label = nullptr);
+  void end();
+  bool clear();
+  bool remove(const char *key);
+  bool isKey(const char *key);
+
+  size_t putUChar(const char *key, uint8_t value) { return putRaw(key, &value, sizeof(value)); }
+  size_t putULong(const char *key, uint32_t value) { return putRaw(key, &value, sizeof(value)); }
+  size_t putULong64(const char *key, uint64_t value) { return putRaw(key, &value, sizeof(value)); }
+  size_t putBool(const char *key, bool value) { uint8_t v = value; return putRaw(key, &v, sizeof(v)); }
+  size_t putBytes(const char *key, const void *value, size_t len) { return putRaw(key, value, len); }
+
+  uint8_t getUChar(const char *key, uint8_t defaultValue = 0) { getRaw(key, &defaultValue, sizeof(defaultValue)); return defaultValue; }
+  uint32_t getULong(const char *key, uint32_t defaultValue = 0) { getRaw(key, &defaultValue, sizeof(defaultValue)); return defaultValue; }
+  uint64_t getULong64(const char *key, uint64_t defaultValue = 0) { getRaw(key, &defaultValue, sizeof(defaultValue)); return defaultValue; }
+  bool getBool(const char *key, bool defaultValue = false) { uint8_t v = defaultValue; getRaw(key, &v, sizeof(v)); return v; }
+  size_t getBytesLength(const char *key);
+  size_t getBytes(const char *key, void *buf, size_t maxLen) { return getRaw(key, buf, maxLen); }
+
+private:
+  size_t putRaw(const char *key, const void *value, size_t len);
+  size_t getRaw(const char *key, void *buf, size_t len);
+  std::string namespace_;
+  bool open_ = false;
+  bool readOnly_ = true;
+};
+
+#endif // PREFERENCES_H_HOST_SHIM
@@ -0,0 +1,58 @@
+// Host shim for the ESP32 WiFi class. The access point never really starts;
+// station count can be scripted from the host tools.
+#ifndef WIFI_H_HOST_SHIM
+#define WIFI_H_HOST_SHIM
+
+#include <Arduino.h>
+
+class IPAddress {
+public:
+  IPAddress() : IPAddress(0, 0, 0, 0) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) { bytes_[0] = a; bytes_[1] = b; bytes_[2] = c; bytes_[3] = d; }
+  uint8_t operator[](int i) const { return bytes_[i]; }
+  String toString() const;
+
+private:
+  uint8_t bytes_[4];
+};
+
+typedef enum {
+  WIFI_OFF = 0,
+  WIFI_STA = 1,
+  WIFI_AP = 2,
+  WIFI_AP_STA = 3
+} wifi_mode_t;
+
+typedef enum {
+  ARDUINO_EVENT_WIFI_AP_STACONNECTED,
+  ARDUINO_EVENT_WIFI_AP_STADISCONNECTED
+} arduino_event_id_t;
+typedef arduino_event_id_t WiFiEvent_t;
+typedef struct { uint8_t mac[6]; } WiFiEventInfo_t;
+typedef void (*WiFiEventFuncCb)(WiFiEvent_t event, WiFiEventInfo_t info);
+
+class WiFiClass {
+public:
+  bool mode(wifi_mode_t m) { mode_ = m; return true; }
+  wifi_mode_t getMode() const { return mode_; }
+  bool softAP(const char *ssid, const char *passphrase = nullptr) { (void)ssid; (void)passphrase; return true; }
+  bool softAPConfig(IPAddress local_ip, IPAddress gateway, IPAddress subnet) { (void)gateway; (void)subnet; ip_ = local_ip; return true; }
+  bool softAPdisconnect(bool wifioff = false) { if (wifioff) mode_ = WIFI_OFF; stations_ = 0; return true; }
+  IPAddress softAPIP() const { return ip_; }
+  uint8_t softAPgetStationNum() const { return stations_; }
+  void onEvent(WiFiEventFuncCb cb, arduino_event_id_t event);
+
+  // Host only: pretend a phone joined or left the access point
+  void hostSetStations(uint8_t n);
+
+private:
+  wifi_mode_t mode_ = WIFI_OFF;
+  IPAddress ip_;
+  uint8_t stations_ = 0;
+  WiFiEventFuncCb connected_ = nullptr;
+  WiFiEventFuncCb disconnected_ = nullptr;
+};
+
+extern WiFiClass WiFi;
+
+#endif // WIFI_H_HOST_SHIM
@@ -0,0 +1,32 @@
+// Host shim for ESP-IDF power management. Like an Arduino core built without
+// CONFIG_PM_ENABLE, esp_pm_configure() reports ESP_ERR_NOT_SUPPORTED, so the
+// firmware scales the clock with setCpuFrequencyMhz() on the host.
+#ifndef ESP_PM_H_HOST_SHIM
+#define ESP_PM_H_HOST_SHIM
+
+#include <driver/gpio.h>
+
+#ifndef ESP_ERR_NOT_SUPPORTED
+#define ESP_ERR_NOT_SUPPORTED 0x106
+#endif
+
+typedef enum {
+  ESP_PM_CPU_FREQ_MAX,
+  ESP_PM_APB_FREQ_MAX,
+  ESP_PM_NO_LIGHT_SLEEP
+} esp_pm_lock_type_t;
+
+typedef struct {
+  int max_freq_mhz;
+  int min_freq_mhz;
+  bool light_sleep_enable;
+} esp_pm_config_esp32c3_t;
+
+typedef struct esp_pm_lock *esp_pm_lock_handle_t;
+
+esp_err_t esp_pm_configure(const void *config);
+esp_err_t esp_pm_lock_create(esp_pm_lock_type_t lock_type, int arg, const char *name, esp_pm_lock_handle_t *out_handle);
+esp_err_t esp_pm_lock_acquire(esp_pm_lock_handle_t handle);
+esp_err_t esp_pm_lock_release(esp_pm_lock_handle_t handle);
+
+#endif // ESP_PM_H_HOST_SHIM
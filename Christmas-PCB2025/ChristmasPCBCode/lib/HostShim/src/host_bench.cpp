@@ -0,0 +1,89 @@
+// bench: per-call latency of loop() and the pattern functions on the host
+#include "HostShim.h"
+#include "HostTools.h"
+#include "patterns.h"
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// Firmware entry points (src/main.cpp)
+void setup();
+void loop();
+extern CRGB leds[];
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Options {
+  uint32_t iterations = 100000;
+};
+
+void printHeader() {
+  printf("%-26s %10s %10s %10s %10s %10s\n", "function", "calls", "mean ns", "p50 ns", "p99 ns", "max ns");
+}
+
+void printLatencies(const char *name, std::vector<uint32_t> &samples) {
+  if (samples.empty()) return;
+  uint64_t total = 0;
+  for (uint32_t s : samples) total += s;
+  std::sort(samples.begin(), samples.end());
+  printf("%-26s %10zu %10llu %10u %10u %10u\n", name, samples.size(),
+         (unsigned long long)(total / samples.size()),
+         samples[samples.size() / 2],
+         samples[(samples.size() * 99) / 100],
+         samples.back());
+}
+
+// Times fn once per iteration; the virtual clock moves 1 ms between calls
+template <typename Fn>
+void benchFunction(const char *name, uint32_t iterations, Fn fn) {
+  std::vector<uint32_t> samples;
+  samples.reserve(iterations);
+  for (uint32_t i = 0; i < iterations; i++) {
+    hostshim::advanceMillis(1);
+    Clock::time_point start = Clock::now();
+    fn();
+    Clock::time_point end = Clock::now();
+    samples.push_back((uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+  }
+  printLatencies(name, samples);
+}
+
+int runBench(const Options &opts) {
+  setup();
+
+  printf("Per-call latency on the host, %u iterations each\n", opts.iterations);
+  printHeader();
+  benchFunction("loop()", opts.iterations, loop);
+
+  // Every registry entry, stepped from its own state in the shared arena
+  char name[32];
+  for (int mode = 0; mode < NUM_DISPLAY_MODES; mode++) {
+    beginPattern((DisplayMode)mode, leds, CRGB::Red);
+    snprintf(name, sizeof(name), "step %s (%u B)", patterns[mode].name, patterns[mode].stateSize);
+    benchFunction(name, opts.iterations, [mode] { stepPattern((DisplayMode)mode, leds); });
+  }
+  return 0;
+}
+
+} // namespace
+
+int benchMain(int argc, char **argv) {
+  Options opts;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+      opts.iterations = strtoul(argv[++i], nullptr, 10);
+    } else {
+      fprintf(stderr, "bench: unknown option %s\n", argv[i]);
+      return 2;
+    }
+  }
+
+  return runBench(opts);
+}
@@ -0,0 +1,179 @@
+// heapbench: fires a long mix of portal requests at the firmware with the heap
+// model on and reports free heap, the largest free block and fragmentation as
+// the run goes, plus the allocations each handler makes per request.
+#include "HostShim.h"
+#include "HostTools.h"
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <WiFi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+// Firmware entry points and state (src/main.cpp)
+void setup();
+void loop();
+void startWiFiAP();
+extern bool wifiAPEnabled;
+
+namespace {
+
+struct Options {
+  uint32_t requests = 100000;
+  uint32_t heapKb = 160;   // free heap of the C3 with the AP and server up
+  uint32_t sampleEvery = 10000;
+  uint32_t seed = 1;
+};
+
+typedef std::map<std::string, std::string> Params;
+
+// One kind of request in the mix; weights add up to 100
+struct Endpoint {
+  const char *uri;
+  uint8_t weight;
+  bool revalidate;  // sends the ETag of its last answer
+  uint32_t requests;
+  uint32_t handlerAllocations;
+  std::vector<Params> variants;
+  std::string etag;
+};
+
+uint32_t nextRandom(uint32_t &state) {
+  state = state * 1664525u + 1013904223u;
+  return state >> 8;
+}
+
+void printSample(uint32_t requests) {
+  hostshim::HeapStats heap = hostshim::heapStats();
+  // Share of the free heap that is not in the largest block
+  double fragmentation = heap.freeBytes ? 100.0 * (heap.freeBytes - heap.largestFree) / heap.freeBytes : 0;
+  printf("%10u %10zu %10zu %10zu %6.1f%% %8u %8u\n", requests, heap.freeBytes, heap.minFreeBytes, heap.largestFree,
+         fragmentation, heap.liveBlocks, heap.failed);
+}
+
+int runHeapBench(const Options &opts) {
+  setup();
+  startWiFiAP();
+  WiFi.hostSetStations(1);
+  loop();
+
+  AsyncWebServer *server = AsyncWebServer::hostInstance();
+  AsyncWebSocket *socket = server ? server->hostSocket("/ws") : nullptr;
+  if (!server || !socket) {
+    fprintf(stderr, "heapbench: the portal did not start\n");
+    return 2;
+  }
+
+  // Parameters are prepared up front so only the firmware and the server
+  // allocate while the model runs
+  std::vector<Endpoint> endpoints = {
+    {"/set", 30, false, 0, 0, {}, ""},
+    {"/play", 10, false, 0, 0, {}, ""},
+    {"/stop", 10, false, 0, 0, {}, ""},
+    {"/api/state", 20, true, 0, 0, {}, ""},
+    {"/api/catalog", 5, true, 0, 0, {}, ""},
+    {"/", 5, true, 0, 0, {}, ""},
+    {"/generate_204", 10, false, 0, 0, {}, ""},
+    {"/favicon.ico", 5, false, 0, 0, {}, ""},
+    {"/ws", 5, false, 0, 0, {}, ""},
+  };
+  uint32_t random = opts.seed;
+  for (Endpoint &endpoint : endpoints) {
+    for (int i = 0; i < 32; i++) {
+      Params params;
+      if (strcmp(endpoint.uri, "/set") == 0) {
+        params["brightness"] = std::to_string(10 + nextRandom(random) % 246);
+        params["pattern"] = std::to_string(nextRandom(random) % 14);
+        params["timer"] = std::to_string(nextRandom(random) % 2);
+        if (i % 8 == 0) params["pattern"] = "12abc";  // rejected
+      } else if (strcmp(endpoint.uri, "/play") == 0) {
+        params["song"] = std::to_string(nextRandom(random) % 20);
+      }
+      endpoint.variants.push_back(params);
+    }
+  }
+  AsyncWebSocketClient *client = socket->hostConnect();
+  const uint8_t previewOn[] = {0x10, 1};
+  socket->hostSend(client, previewOn, sizeof(previewOn));
+  Params headers;
+
+  hostshim::heapModelBegin((size_t)opts.heapKb * 1024);
+  printf("Heap model: %u KB, %u requests\n", opts.heapKb, opts.requests);
+  printf("%10s %10s %10s %10s %7s %8s %8s\n", "requests", "free", "min free", "largest", "frag", "blocks", "failed");
+  printSample(0);
+
+  for (uint32_t n = 1; n <= opts.requests; n++) {
+    uint32_t pick = nextRandom(random) % 100;
+    Endpoint *endpoint = &endpoints.back();
+    for (Endpoint &candidate : endpoints) {
+      if (pick < candidate.weight) {
+        endpoint = &candidate;
+        break;
+      }
+      pick -= candidate.weight;
+    }
+
+    if (strcmp(endpoint->uri, "/ws") == 0) {
+      uint8_t frame[] = {2, (uint8_t)(nextRandom(random) % 14), 1, (uint8_t)(10 + nextRandom(random) % 246)};
+      socket->hostSend(client, frame, sizeof(frame));
+    } else {
+      {
+        hostshim::HeapModelPause pause;
+        headers.clear();
+        if (endpoint->revalidate && !endpoint->etag.empty() && n % 2 == 0) headers["If-None-Match"] = endpoint->etag;
+      }
+      server->hostRequest(endpoint->uri, endpoint->variants[n % endpoint->variants.size()], headers);
+      endpoint->handlerAllocations += server->hostLastHandlerAllocations();
+      hostshim::HeapModelPause pause;
+      if (endpoint->revalidate) endpoint->etag = server->hostLastHeader("ETag");
+    }
+    endpoint->requests++;
+
+    hostshim::advanceMillis(1);
+    loop();
+    if (!wifiAPEnabled) {
+      fprintf(stderr, "heapbench: the AP closed after %u requests\n", n);
+      break;
+    }
+    if (n % opts.sampleEvery == 0) printSample(n);
+  }
+
+  hostshim::HeapStats heap = hostshim::heapStats();
+  hostshim::heapModelEnd();
+
+  printf("\n%-16s %10s %14s\n", "handler", "requests", "allocs/request");
+  for (const Endpoint &endpoint : endpoints) {
+    if (endpoint.requests == 0 || strcmp(endpoint.uri, "/ws") == 0) continue;
+    printf("%-16s %10u %14.2f\n", endpoint.uri, endpoint.requests,
+           (double)endpoint.handlerAllocations / endpoint.requests);
+  }
+  printf("Allocations: %u in total, %u failed\n", heap.allocations, heap.failed);
+  return heap.failed > 0 ? 1 : 0;
+}
+
+} // namespace
+
+int heapBenchMain(int argc, char **argv) {
+  Options opts;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--requests") == 0 && i + 1 < argc) {
+      opts.requests = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--heap-kb") == 0 && i + 1 < argc) {
+      opts.heapKb = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--sample") == 0 && i + 1 < argc) {
+      opts.sampleEvery = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      opts.seed = strtoul(argv[++i], nullptr, 10);
+    } else {
+      fprintf(stderr, "heapbench: unknown option %s\n", argv[i]);
+      return 2;
+    }
+  }
+
+  if (opts.sampleEvery == 0) opts.sampleEvery = 1;
+  return runHeapBench(opts);
+}
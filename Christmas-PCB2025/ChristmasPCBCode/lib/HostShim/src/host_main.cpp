@@ -0,0 +1,43 @@
+// Host entry point for the native environment.
+//
+//   .pio/build/native/program bench [--iterations N]
+//   .pio/build/native/program sim [--hours H] [--pass-us U] [--start-millis M] [--timer] [--wifi] [--battery] [--song]
+//                                 [--wake-at H] [--adc-noise N] [--led-droop N] [--drain H]
+//   .pio/build/native/program render [--out DIR] [--song N] [--golden DIR | --check DIR] [--no-wav]
+//                                    [--pass-us U] [--stall-ms S --stall-every-ms E]
+#include "HostTools.h"
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+
+struct Command {
+  const char *name;
+  int (*run)(int argc, char **argv);
+  const char *help;
+};
+
+const Command commands[] = {
+  {"bench", benchMain, "per-call latency of loop() and the pattern functions"},
+  {"sim", simMain, "drive loop() with a virtual clock over hours or days"},
+  {"render", renderMain, "render songs to WAV and check note timing against golden files"},
+  {"heapbench", heapBenchMain, "portal requests against a model of the heap: free, largest block, fragmentation"},
+};
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const char *name = argc > 1 ? argv[1] : "bench";
+
+  for (const Command &command : commands) {
+    if (strcmp(name, command.name) == 0) {
+      return command.run(argc - 1, argv + 1);
+    }
+  }
+
+  fprintf(stderr, "Unknown command: %s\n", name);
+  for (const Command &command : commands) {
+    fprintf(stderr, "  %-8s %s\n", command.name, command.help);
+  }
+  return 2;
+}
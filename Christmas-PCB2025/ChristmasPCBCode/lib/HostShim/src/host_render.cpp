@@ -0,0 +1,300 @@
+// render: plays every entry of songs[] through the firmware's own song path
+// (startSong() -> audio engine -> tone()) against a virtual buzzer.
+// Writes one WAV per song, a per-note timing report (scheduled vs actual onset
+// under a configurable loop() latency profile) and golden CSVs that later runs
+// can be checked against to catch tempo and duration regressions.
+#include "HostShim.h"
+#include "HostTools.h"
+#include "audio_engine.h"
+#include "christmas_songs.h"
+#include <Arduino.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+
+// Firmware entry points and state (src/main.cpp)
+void setup();
+void loop();
+void startSong();
+extern ChristmasSong currentSong;
+
+namespace {
+
+struct Options {
+  std::string outDir = "render";
+  std::string goldenDir;      // write golden CSVs here
+  std::string checkDir;       // compare against golden CSVs here
+  int song = -1;              // -1 = all
+  bool wav = true;
+  uint32_t sampleRate = 22050;
+  uint32_t passUs = 50;       // CPU time of every loop() pass
+  uint32_t stallMs = 0;       // extra time of a slow pass (web page, LED work)
+  uint32_t stallEveryMs = 0;  // how often a slow pass happens
+};
+
+struct ToneEvent {
+  uint64_t atUs;
+  uint16_t frequency;
+  uint32_t toneMs;
+};
+
+struct SongTiming {
+  uint32_t notes;
+  uint32_t wrongNotes;     // frequency or length differs from the song
+  uint32_t underruns;
+  int64_t maxErrorUs;
+  double meanErrorUs;
+};
+
+std::vector<ToneEvent> toneEvents;
+
+void recordTone(uint64_t atUs, uint8_t pin, unsigned int frequency, unsigned long durationMs) {
+  if (pin != HOST_PIN_BUZZER) return;
+  if (frequency == 0 && durationMs == 0) return;  // noTone()
+  toneEvents.push_back({atUs, (uint16_t)frequency, (uint32_t)durationMs});
+}
+
+std::string slug(const char *name) {
+  std::string s;
+  for (const char *p = name; *p; p++) {
+    if (isalnum((unsigned char)*p)) {
+      s += (char)tolower((unsigned char)*p);
+    } else if (!s.empty() && s.back() != '_') {
+      s += '_';
+    }
+  }
+  while (!s.empty() && s.back() == '_') s.pop_back();
+  return s;
+}
+
+std::string songFile(const std::string &dir, int index, const char *ext) {
+  char prefix[8];
+  snprintf(prefix, sizeof(prefix), "%02d_", index);
+  return dir + "/" + prefix + slug(songs[index].name) + ext;
+}
+
+// mkdir -p
+bool makeDir(const std::string &dir) {
+  for (size_t slash = dir.find('/', 1); slash != std::string::npos; slash = dir.find('/', slash + 1)) {
+    mkdir(dir.substr(0, slash).c_str(), 0755);
+  }
+  if (mkdir(dir.c_str(), 0755) == 0 || errno == EEXIST) return true;
+  fprintf(stderr, "render: cannot create %s: %s\n", dir.c_str(), strerror(errno));
+  return false;
+}
+
+void putLE(FILE *f, uint32_t value, int bytes) {
+  for (int i = 0; i < bytes; i++) fputc((value >> (8 * i)) & 0xFF, f);
+}
+
+// 16-bit mono PCM; the buzzer is a square wave at the tone() frequency
+bool writeWav(const std::string &path, const std::vector<ToneEvent> &events, uint32_t sampleRate) {
+  if (events.empty()) return false;
+  const uint64_t startUs = events.front().atUs;
+  const ToneEvent &lastEvent = events.back();
+  const uint64_t endUs = lastEvent.atUs - startUs + (uint64_t)lastEvent.toneMs * 1000 + 500000;
+  std::vector<int16_t> samples((size_t)(endUs * sampleRate / 1000000), 0);
+
+  for (const ToneEvent &e : events) {
+    if (e.frequency == 0) continue;
+    const size_t first = (size_t)((e.atUs - startUs) * sampleRate / 1000000);
+    const size_t count = (size_t)((uint64_t)e.toneMs * sampleRate / 1000);
+    for (size_t i = 0; i < count && first + i < samples.size(); i++) {
+      const double phase = (double)i * e.frequency / sampleRate;
+      samples[first + i] = (phase - (uint64_t)phase) < 0.5 ? 8000 : -8000;
+    }
+  }
+
+  FILE *f = fopen(path.c_str(), "wb");
+  if (!f) return false;
+  const uint32_t dataBytes = samples.size() * 2;
+  fputs("RIFF", f);
+  putLE(f, 36 + dataBytes, 4);
+  fputs("WAVEfmt ", f);
+  putLE(f, 16, 4);
+  putLE(f, 1, 2);               // PCM
+  putLE(f, 1, 2);               // mono
+  putLE(f, sampleRate, 4);
+  putLE(f, sampleRate * 2, 4);  // bytes per second
+  putLE(f, 2, 2);               // block align
+  putLE(f, 16, 2);              // bits per sample
+  fputs("data", f);
+  putLE(f, dataBytes, 4);
+  fwrite(samples.data(), 2, samples.size(), f);
+  fclose(f);
+  return true;
+}
+
+// What every run must reproduce exactly: onset, pitch and length of each note
+std::string goldenText(const std::vector<ToneEvent> &events) {
+  std::string text = "note,onset_us,frequency,tone_ms\n";
+  char line[64];
+  for (size_t i = 0; i < events.size(); i++) {
+    snprintf(line, sizeof(line), "%zu,%llu,%u,%u\n", i,
+             (unsigned long long)(events[i].atUs - events.front().atUs), events[i].frequency, events[i].toneMs);
+    text += line;
+  }
+  return text;
+}
+
+bool readFile(const std::string &path, std::string &text) {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  char buf[4096];
+  size_t n;
+  text.clear();
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, n);
+  fclose(f);
+  return true;
+}
+
+// Plays one song through loop() with the latency profile applied
+void playSong(int index, const Options &opts) {
+  toneEvents.clear();
+  currentSong = (ChristmasSong)index;
+  startSong();
+
+  uint64_t nextStallUs = hostshim::nowMicros() + (uint64_t)opts.stallEveryMs * 1000;
+  while (!audioFinished()) {
+    hostshim::advanceMicros(opts.passUs);
+    if (opts.stallMs && opts.stallEveryMs && hostshim::nowMicros() >= nextStallUs) {
+      // A slow pass: loop() is busy, only the timer keeps running
+      hostshim::advanceMicros((uint64_t)opts.stallMs * 1000);
+      nextStallUs += (uint64_t)opts.stallEveryMs * 1000;
+    }
+    loop();
+  }
+  // Let updateSong() notice the end
+  for (int i = 0; i < 4; i++) {
+    hostshim::advanceMillis(AUDIO_REFILL_INTERVAL);
+    loop();
+  }
+}
+
+SongTiming compareTiming(int index, FILE *report) {
+  SongTiming timing = {};
+  SongDecoder decoder;
+  CompiledNote note;
+  uint64_t expectedUs = 0;
+  double totalError = 0;
+
+  decoder.begin(songs[index].notes);
+  for (size_t i = 0; decoder.next(note); i++) {
+    timing.notes++;
+    if (i >= toneEvents.size()) {
+      timing.wrongNotes++;
+      continue;
+    }
+    const ToneEvent &e = toneEvents[i];
+    const int64_t actualUs = e.atUs - toneEvents.front().atUs;
+    const int64_t errorUs = actualUs - (int64_t)expectedUs;
+    if (e.frequency != note.frequency || e.toneMs != note.toneMs) timing.wrongNotes++;
+    if (llabs(errorUs) > llabs(timing.maxErrorUs)) timing.maxErrorUs = errorUs;
+    totalError += llabs(errorUs);
+    if (report) {
+      fprintf(report, "%d,%zu,%.3f,%.3f,%lld\n", index, i, expectedUs / 1000.0, actualUs / 1000.0, (long long)errorUs);
+    }
+    expectedUs += (uint64_t)note.durationMs * 1000;
+  }
+  if (toneEvents.size() > timing.notes) timing.wrongNotes += toneEvents.size() - timing.notes;
+  timing.meanErrorUs = timing.notes ? totalError / timing.notes : 0;
+  return timing;
+}
+
+int runRender(const Options &opts) {
+  hostshim::setToneListener(recordTone);
+  setup();
+
+  if (!makeDir(opts.outDir)) return 1;
+  if (!opts.goldenDir.empty() && !makeDir(opts.goldenDir)) return 1;
+  FILE *report = fopen((opts.outDir + "/timing.csv").c_str(), "w");
+  if (report) fputs("song,note,expected_ms,actual_ms,error_us\n", report);
+
+  printf("loop() profile: %u us per pass", opts.passUs);
+  if (opts.stallMs && opts.stallEveryMs) printf(", %u ms stall every %u ms", opts.stallMs, opts.stallEveryMs);
+  printf("\n%-32s %6s %8s %10s %10s %9s %6s %s\n", "song", "notes", "length s", "mean |e| us",
+         "max e us", "underruns", "wrong", opts.checkDir.empty() ? "" : "golden");
+
+  int failures = 0;
+  for (int i = 0; i < NUM_CHRISTMAS_SONGS; i++) {
+    if (opts.song >= 0 && opts.song != i) continue;
+
+    const uint32_t underrunsBefore = audioStats().underruns;
+    playSong(i, opts);
+    SongTiming timing = compareTiming(i, report);
+    timing.underruns = audioStats().underruns - underrunsBefore;
+
+    const char *golden = "";
+    const std::string text = goldenText(toneEvents);
+    if (!opts.goldenDir.empty()) {
+      FILE *f = fopen(songFile(opts.goldenDir, i, ".csv").c_str(), "w");
+      if (f) {
+        fputs(text.c_str(), f);
+        fclose(f);
+      }
+    }
+    if (!opts.checkDir.empty()) {
+      std::string expected;
+      if (!readFile(songFile(opts.checkDir, i, ".csv"), expected)) {
+        golden = "MISSING";
+        failures++;
+      } else if (expected != text) {
+        golden = "DIFFERS";
+        failures++;
+      } else {
+        golden = "ok";
+      }
+    }
+    if (timing.wrongNotes) failures++;
+
+    if (opts.wav) writeWav(songFile(opts.outDir, i, ".wav"), toneEvents, opts.sampleRate);
+
+    const double lengthS = toneEvents.empty() ? 0 : (toneEvents.back().atUs - toneEvents.front().atUs) / 1e6;
+    printf("%-32s %6u %8.1f %10.0f %10lld %9u %6u %s\n", songs[i].name, timing.notes, lengthS,
+           timing.meanErrorUs, (long long)timing.maxErrorUs, timing.underruns, timing.wrongNotes, golden);
+  }
+
+  if (report) fclose(report);
+  printf("Timing report: %s/timing.csv%s\n", opts.outDir.c_str(), opts.wav ? ", WAV files next to it" : "");
+  if (failures) printf("%d song(s) failed\n", failures);
+  return failures ? 1 : 0;
+}
+
+} // namespace
+
+int renderMain(int argc, char **argv) {
+  Options opts;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+      opts.outDir = argv[++i];
+    } else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc) {
+      opts.goldenDir = argv[++i];
+    } else if (strcmp(argv[i], "--check") == 0 && i + 1 < argc) {
+      opts.checkDir = argv[++i];
+    } else if (strcmp(argv[i], "--song") == 0 && i + 1 < argc) {
+      opts.song = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--no-wav") == 0) {
+      opts.wav = false;
+    } else if (strcmp(argv[i], "--sample-rate") == 0 && i + 1 < argc) {
+      opts.sampleRate = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--pass-us") == 0 && i + 1 < argc) {
+      opts.passUs = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--stall-ms") == 0 && i + 1 < argc) {
+      opts.stallMs = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--stall-every-ms") == 0 && i + 1 < argc) {
+      opts.stallEveryMs = strtoul(argv[++i], nullptr, 10);
+    } else {
+      fprintf(stderr, "render: unknown option %s\n", argv[i]);
+      return 2;
+    }
+  }
+
+  if (opts.passUs == 0) opts.passUs = 1;
+  if (opts.sampleRate < 8000) opts.sampleRate = 8000;
+  return runRender(opts);
+}
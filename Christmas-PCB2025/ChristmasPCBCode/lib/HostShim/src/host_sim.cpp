@@ -0,0 +1,228 @@
+// sim: drives loop() with a virtual millis() so hours of behaviour run in seconds.
+// Scripted button presses exercise the 6h/18h timer and the WiFi AP timeout;
+// at the end it reports LED, buzzer and NVS activity for the simulated span.
+// Deep sleep restarts the firmware through setup(), as on the board.
+#include "HostShim.h"
+#include "HostTools.h"
+#include "audio_engine.h"
+#include "battery_ladder.h"
+#include "battery_monitor.h"
+#include "fuel_gauge.h"
+#include "power_manager.h"
+#include "settings_store.h"
+#include <Arduino.h>
+#include <WiFi.h>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// Firmware entry points and state (src/main.cpp)
+void setup();
+void loop();
+extern uint32_t totalUptimeLow;
+extern uint32_t totalUptimeHigh;
+extern bool wifiAPEnabled;
+extern uint32_t framesShown;
+extern uint32_t framesSkipped;
+extern uint32_t framesLimited;
+
+namespace {
+
+struct Options {
+  double hours = 24.0;
+  uint32_t passUs = 50;
+  uint32_t startMillis = 0;
+  bool timer = false;
+  bool wifi = false;
+  bool battery = false;
+  bool song = false;
+  double wakeAtHours = -1;  // button 1 press, e.g. to wake the board from deep sleep
+  uint16_t adcNoise = 0;    // counts, on the battery sense pin
+  uint16_t ledDroop = 0;    // counts the sense pin sags with every LED at full white
+  double drainHours = 0;    // the cells run from 2400 mV to flat over this many hours
+};
+
+// Phone joining or leaving the access point
+struct StationEvent {
+  uint32_t atMs;
+  uint8_t stations;
+};
+
+const double SEASON_HOURS = 6 * 7 * 24;
+
+// Battery sense pin: 2400 mV (two healthy AAA cells) down to 1400 mV, flat
+const double BATTERY_FULL_MV = 2400;
+const double BATTERY_FLAT_MV = 1400;
+
+void setBatteryMillivolts(double millivolts) {
+  hostshim::setAnalogPin(HOST_PIN_BATT_SENSE, (uint16_t)(millivolts * 4095 / 3300 + 0.5));
+}
+
+// Button press relative to the end of setup(); the shim applies it as the clock passes
+void pressButton(uint64_t startUs, uint32_t atMs, uint8_t pin, uint32_t holdMs) {
+  hostshim::scheduleDigitalPin(startUs + (uint64_t)atMs * 1000, pin, LOW);
+  hostshim::scheduleDigitalPin(startUs + (uint64_t)(atMs + holdMs) * 1000, pin, HIGH);
+}
+
+uint64_t uptimeSeconds() {
+  return ((uint64_t)totalUptimeHigh << 32) | totalUptimeLow;
+}
+
+int runSim(const Options &opts) {
+  std::vector<StationEvent> stationEvents;
+
+  if (opts.battery) setBatteryMillivolts(BATTERY_FULL_MV);
+  hostshim::setAnalogNoise(HOST_PIN_BATT_SENSE, opts.adcNoise, opts.ledDroop);
+
+  hostshim::advanceMillis(opts.startMillis);
+  setup();
+  hostshim::resetStats();
+
+  const uint64_t startUs = hostshim::nowMicros();
+  const uint64_t endUs = startUs + (uint64_t)(opts.hours * 3600.0 * 1e6);
+  hostshim::setSleepLimit(endUs);
+  const uint64_t startUptime = uptimeSeconds();
+  const uint32_t startShown = framesShown;
+  const uint32_t startSkipped = framesSkipped;
+  const uint32_t startLimited = framesLimited;
+  size_t nextStation = 0;
+
+  if (opts.timer) {
+    // Long press on button 1 toggles the 6h timer
+    pressButton(startUs, 1000, HOST_PIN_BUTTON1, 2500);
+  }
+  if (opts.wifi) {
+    // Both buttons for 1.5 s start the AP; a phone then visits for a minute
+    pressButton(startUs, 5000, HOST_PIN_BUTTON1, 1500);
+    pressButton(startUs, 5000, HOST_PIN_BUTTON2, 1500);
+    stationEvents.push_back({20000, 1});
+    stationEvents.push_back({80000, 0});
+  }
+  if (opts.song) {
+    // Button 2 plays the next song
+    pressButton(startUs, 10000, HOST_PIN_BUTTON2, 200);
+  }
+  if (opts.wakeAtHours >= 0) {
+    pressButton(startUs, (uint32_t)(opts.wakeAtHours * 3600000.0), HOST_PIN_BUTTON1, 200);
+  }
+  uint64_t iterations = 0;
+  uint64_t litUs = 0;
+  uint64_t wifiUs = 0;
+
+  std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+
+  uint64_t now = startUs;
+  while (now < endUs) {
+    const uint64_t relMs = (now - startUs) / 1000;
+    if (opts.battery && opts.drainHours > 0) {
+      const double drained = relMs / (opts.drainHours * 3.6e6);
+      setBatteryMillivolts(BATTERY_FULL_MV - (BATTERY_FULL_MV - BATTERY_FLAT_MV) * (drained < 1 ? drained : 1));
+    }
+    while (nextStation < stationEvents.size() && stationEvents[nextStation].atMs <= relMs) {
+      if (wifiAPEnabled) WiFi.hostSetStations(stationEvents[nextStation].stations);
+      nextStation++;
+    }
+
+    // Each pass costs some CPU time; loop() then idles until its next deadline
+    hostshim::advanceMicros(opts.passUs);
+    loop();
+    iterations++;
+
+    const uint64_t after = hostshim::nowMicros();
+    if (hostshim::lastShowLit()) litUs += after - now;
+    if (wifiAPEnabled) wifiUs += after - now;
+    now = after;
+    if (hostshim::takeRestart()) setup();
+  }
+
+  const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+  const double simHours = (now - startUs) / 3.6e9;
+  const hostshim::Stats &s = hostshim::stats();
+
+  printf("Simulated %.2f h in %.2f s wall (%.0fx), %llu loop() passes (%.1f/s)\n",
+         simHours, wallSeconds, simHours * 3600.0 / wallSeconds, (unsigned long long)iterations,
+         iterations / (simHours * 3600.0));
+  printf("millis() %u -> %u%s\n", opts.startMillis, millis(),
+         s.deepSleeps ? " (restarted by deep sleep)" : millis() < opts.startMillis ? " (rolled over)" : "");
+  printf("Uptime counter:   +%llu s (expected %.0f s)\n",
+         (unsigned long long)(uptimeSeconds() - startUptime), simHours * 3600.0);
+  printf("LEDs lit:         %.2f h\n", litUs / 3.6e9);
+  printf("WiFi AP active:   %.0f s\n", wifiUs / 1e6);
+  printf("CPU idle:         %.1f%% light sleep (%u entries), %.1f%% delay()\n",
+         100.0 * s.lightSleepUs / (now - startUs), s.lightSleeps, 100.0 * s.delayUs / (now - startUs));
+  printf("Deep sleep:       %.1f%% (%u entries)\n", 100.0 * s.deepSleepUs / (now - startUs), s.deepSleeps);
+  const PowerStats &power = powerStats();
+  const uint32_t duty = powerDutyPermille();
+  const double awakeMs = power.awakeMs[POWER_160MHZ] + power.awakeMs[POWER_80MHZ] + power.awakeMs[POWER_40MHZ];
+  printf("CPU clock:        %.0f s at 160 MHz, %.0f s at 80, %.0f s at 40 (%.2f%% of the time awake), %u changes\n",
+         power.awakeMs[POWER_160MHZ] / 1e3, power.awakeMs[POWER_80MHZ] / 1e3, power.awakeMs[POWER_40MHZ] / 1e3,
+         100.0 * awakeMs / (awakeMs + power.sleepMs), s.cpuClockChanges);
+  printf("Current duty:     %u.%u%% of running at 160 MHz outside deep sleep, %u show()/tone() below 80 MHz\n",
+         duty / 10, duty % 10, s.slowClockOutputs);
+  printf("FastLED.show():   %u (%.0f/h), %u unchanged frames skipped\n",
+         s.ledShows, s.ledShows / simHours, framesSkipped - startSkipped);
+  printf("Frames sent:      %u of %u, %u dimmed by the power budget\n", framesShown - startShown,
+         (framesShown - startShown) + (framesSkipped - startSkipped), framesLimited - startLimited);
+  printf("tone():           %u, noTone(): %u\n", s.tones, s.noTones);
+  printf("Battery sense:    %u-%u mV filtered over %u bursts, %u source steps\n",
+         batteryStats().minMv, batteryStats().maxMv, batteryStats().bursts, batteryStats().resets);
+  // 0 minutes: no draw measured yet, e.g. right after a deep sleep wake-up
+  const uint32_t minutes = fuelMinutesRemaining();
+  char runtime[32] = "unknown";
+  if (minutes) snprintf(runtime, sizeof(runtime), "%uh %02um", minutes / 60, minutes % 60);
+  printf("Fuel gauge:       %u mAh used (%u%% left), %s left at the last draw\n",
+         fuelConsumedMah(), fuelPercent(), runtime);
+  printf("Battery ladder:   ended at \"%s\" (%u mV filtered)\n", ladderStep().name, batteryMillivolts());
+  printf("Audio engine:     %u notes, %u underruns, max onset lateness %u us\n",
+         audioStats().notesPlayed, audioStats().underruns, audioStats().maxLatenessUs);
+  printf("NVS sessions:     %u (%.1f/h)\n", s.nvsSessions, s.nvsSessions / simHours);
+  printf("NVS writes:       %u, %u changed a value, %u bytes (%.0f bytes/h)\n",
+         s.nvsWrites, s.nvsChangedWrites, s.nvsBytesWritten, s.nvsBytesWritten / simHours);
+  printf("Uptime log:       %u bytes in %u records, %u sector erases\n",
+         s.partitionBytesWritten, storeStats().logRecords, s.partitionErases);
+  printf("Flash written:    %u bytes (%.0f bytes/h), counting 32 bytes per NVS entry\n",
+         storeStats().flashBytes, storeStats().flashBytes / simHours);
+  printf("Season (%.0f h):  ~%.0f NVS writes, ~%.0f flash bytes\n",
+         SEASON_HOURS, s.nvsWrites / simHours * SEASON_HOURS, storeStats().flashBytes / simHours * SEASON_HOURS);
+  return 0;
+}
+
+} // namespace
+
+int simMain(int argc, char **argv) {
+  Options opts;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--hours") == 0 && i + 1 < argc) {
+      opts.hours = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--pass-us") == 0 && i + 1 < argc) {
+      opts.passUs = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--start-millis") == 0 && i + 1 < argc) {
+      opts.startMillis = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--timer") == 0) {
+      opts.timer = true;
+    } else if (strcmp(argv[i], "--wifi") == 0) {
+      opts.wifi = true;
+    } else if (strcmp(argv[i], "--battery") == 0) {
+      opts.battery = true;
+    } else if (strcmp(argv[i], "--song") == 0) {
+      opts.song = true;
+    } else if (strcmp(argv[i], "--wake-at") == 0 && i + 1 < argc) {
+      opts.wakeAtHours = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--adc-noise") == 0 && i + 1 < argc) {
+      opts.adcNoise = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--led-droop") == 0 && i + 1 < argc) {
+      opts.ledDroop = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--drain") == 0 && i + 1 < argc) {
+      opts.drainHours = atof(argv[++i]);
+    } else {
+      fprintf(stderr, "sim: unknown option %s\n", argv[i]);
+      return 2;
+    }
+  }
+
+  if (opts.passUs == 0) opts.passUs = 1;
+  return runSim(opts);
+}
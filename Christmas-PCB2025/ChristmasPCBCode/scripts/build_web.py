@@ -0,0 +1,94 @@
+# PlatformIO pre-build step: minifies web/index.html, gzips it and writes the
+# result to include/web_assets.h as a PROGMEM byte array with an ETag.
+# The header is only rewritten when the page changes, so it doesn't force a
+# rebuild. Can also be run by hand: python3 scripts/build_web.py
+import gzip
+import hashlib
+import os
+import re
+
+try:
+    Import("env")
+    PROJECT_DIR = env.subst("$PROJECT_DIR")
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE = os.path.join(PROJECT_DIR, "web", "index.html")
+HEADER = os.path.join(PROJECT_DIR, "include", "web_assets.h")
+
+
+def minify_css(css):
+    css = re.sub(r"/\*.*?\*/", "", css, flags=re.S)
+    css = re.sub(r"\s+", " ", css)
+    css = re.sub(r"\s*([{};:,>])\s*", r"\1", css)
+    return css.replace(";}", "}").strip()
+
+
+def minify_js(js):
+    lines = []
+    for line in js.splitlines():
+        line = line.strip()
+        # Only whole-line comments: '//' also appears inside strings
+        if line and not line.startswith("//"):
+            lines.append(line)
+    # Keep the line breaks so automatic semicolon insertion still works
+    return "\n".join(lines)
+
+
+def minify_html(html):
+    parts = re.split(r"(<style>.*?</style>|<script>.*?</script>)", html, flags=re.S)
+    out = []
+    for part in parts:
+        if part.startswith("<style>"):
+            out.append("<style>" + minify_css(part[7:-8]) + "</style>")
+        elif part.startswith("<script>"):
+            out.append("<script>" + minify_js(part[8:-9]) + "</script>")
+        else:
+            # Browsers render any run of whitespace as one space
+            part = re.sub(r"<!--.*?-->", "", part, flags=re.S)
+            part = re.sub(r"\s+", " ", part)
+            out.append(re.sub(r"\s*(<(?:/?(?:html|head|body|meta|title|style|script|div|select|option)\b[^>]*)>)\s*",
+                              r"\1", part))
+    return "".join(out).strip()
+
+
+def render_header(raw, minified, packed):
+    etag = hashlib.sha1(packed).hexdigest()[:16]
+    lines = [
+        "// Generated by scripts/build_web.py from web/index.html - do not edit.",
+        "// %d bytes raw, %d minified, %d gzipped" % (len(raw), len(minified), len(packed)),
+        "#ifndef WEB_ASSETS_H",
+        "#define WEB_ASSETS_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "#define WEB_INDEX_ETAG \"\\\"%s\\\"\"" % etag,
+        "",
+        "const size_t WEB_INDEX_GZ_LENGTH = %d;" % len(packed),
+        "",
+        "const uint8_t webIndexGz[WEB_INDEX_GZ_LENGTH] PROGMEM = {",
+    ]
+    for i in range(0, len(packed), 16):
+        lines.append("  " + ", ".join("0x%02x" % b for b in packed[i:i + 16]) + ",")
+    lines += ["};", "", "#endif // WEB_ASSETS_H", ""]
+    return "\n".join(lines)
+
+
+def build_web():
+    with open(SOURCE, encoding="utf-8") as f:
+        raw = f.read().encode("utf-8")
+    minified = minify_html(raw.decode("utf-8")).encode("utf-8")
+    # mtime=0 keeps the output (and the ETag) identical between builds
+    packed = gzip.compress(minified, compresslevel=9, mtime=0)
+    header = render_header(raw, minified, packed)
+
+    if os.path.exists(HEADER):
+        with open(HEADER, encoding="utf-8") as f:
+            if f.read() == header:
+                return
+    with open(HEADER, "w", encoding="utf-8") as f:
+        f.write(header)
+    print("web/index.html: %d bytes -> %d minified -> %d gzipped" % (len(raw), len(minified), len(packed)))
+
+
+build_web()
@@ -0,0 +1,54 @@
+# PlatformIO post-build step: how many bytes each packed song takes in the
+# firmware compared with its raw {pitch, note type} melody (4 bytes per note).
+# Sizes are read from the linked program, so the report is always what ships.
+import os
+import re
+import subprocess
+
+Import("env")
+
+SONGS_HEADER = os.path.join(env.subst("$PROJECT_INCLUDE_DIR"), "christmas_songs.h")
+
+
+def melody_notes():
+    with open(SONGS_HEADER) as f:
+        text = re.sub(r"//.*", "", f.read())
+    notes = {}
+    for name, body in re.findall(r"const int16_t (\w+)\[\] PROGMEM\s*\{(.*?)\};", text, re.S):
+        values = [v for v in body.replace("\n", " ").split(",") if v.strip()]
+        notes[name] = len(values) // 2
+    return notes
+
+
+def packed_sizes(program):
+    nm = env.subst("$CC").replace("gcc", "nm")
+    output = subprocess.check_output([nm, "-C", "-S", program], universal_newlines=True)
+    sizes = {}
+    for line in output.splitlines():
+        match = re.match(r"[0-9a-f]+ ([0-9a-f]+) \w packedSong<(\w+), \d+>$", line)
+        if match:
+            sizes[match.group(2)] = int(match.group(1), 16)
+    return sizes
+
+
+def song_report(source, target, env):
+    notes = melody_notes()
+    try:
+        sizes = packed_sizes(target[0].get_abspath())
+    except (OSError, subprocess.CalledProcessError) as e:
+        print("Song report skipped: %s" % e)
+        return
+
+    print("\nSong bank (raw melody vs packed)")
+    print("%-24s %6s %8s %8s %8s" % ("melody", "notes", "raw B", "packed B", "saved B"))
+    total_raw = total_packed = 0
+    for name in sorted(sizes):
+        raw = notes.get(name, 0) * 4
+        total_raw += raw
+        total_packed += sizes[name]
+        print("%-24s %6d %8d %8d %8d" % (name, notes.get(name, 0), raw, sizes[name], raw - sizes[name]))
+    print("%-24s %6s %8d %8d %8d (%.0f%%)\n" % ("total", "", total_raw, total_packed,
+          total_raw - total_packed, 100.0 * (total_raw - total_packed) / max(total_raw, 1)))
+
+
+env.AddPostAction("$PROGPATH", song_report)
@@ -0,0 +1,156 @@
+#include "audio_engine.h"
+#include <atomic>
+#include <esp_timer.h>
+
+struct QueuedNote {
+  uint32_t onsetMs;    // from the start of the song
+  uint16_t frequency;
+  uint16_t toneMs;
+  bool last;
+};
+
+// Single-producer (loop) / single-consumer (esp_timer task) ring buffer
+static QueuedNote noteQueue[AUDIO_QUEUE_LENGTH];
+static std::atomic<uint16_t> queueHead(0);   // next slot the timer plays
+static std::atomic<uint16_t> queueTail(0);   // next slot loop() fills
+static std::atomic<bool> timerArmed(false);
+static std::atomic<bool> songFinished(true);
+
+static esp_timer_handle_t noteTimer = nullptr;
+static uint8_t buzzer = 0;
+static int64_t songStartUs = 0;
+static AudioStats stats;
+
+// Decoder state, only touched by loop()
+static SongDecoder decoder;
+static bool endQueued = true;
+static uint32_t nextOnsetMs = 0;
+static uint8_t duty = 100;  // percent of toneMs
+
+static void armTimerFor(const QueuedNote& note) {
+  int64_t wait = songStartUs + (int64_t)note.onsetMs * 1000 - esp_timer_get_time();
+  esp_timer_start_once(noteTimer, wait > 0 ? wait : 0);
+}
+
+// Arms the timer for the head of the queue unless it is already running
+static void armIfIdle() {
+  uint16_t head = queueHead.load(std::memory_order_acquire);
+  if (head == queueTail.load(std::memory_order_acquire)) return;
+  bool expected = false;
+  if (timerArmed.compare_exchange_strong(expected, true)) {
+    armTimerFor(noteQueue[head % AUDIO_QUEUE_LENGTH]);
+  }
+}
+
+static void onNoteTimer(void* arg) {
+  uint16_t head = queueHead.load(std::memory_order_relaxed);
+  if (head == queueTail.load(std::memory_order_acquire)) {
+    stats.underruns++;
+    timerArmed.store(false, std::memory_order_release);
+    armIfIdle();
+    return;
+  }
+
+  const QueuedNote& note = noteQueue[head % AUDIO_QUEUE_LENGTH];
+  int64_t lateness = esp_timer_get_time() - (songStartUs + (int64_t)note.onsetMs * 1000);
+  if (lateness > (int64_t)stats.maxLatenessUs) stats.maxLatenessUs = lateness;
+
+  if (note.last) {
+    noTone(buzzer);
+    songFinished.store(true, std::memory_order_release);
+  } else {
+    tone(buzzer, note.frequency, note.toneMs);
+    stats.notesPlayed++;
+  }
+  queueHead.store(head + 1, std::memory_order_release);
+
+  if (note.last) {
+    timerArmed.store(false, std::memory_order_release);
+    return;
+  }
+
+  uint16_t next = head + 1;
+  if (next != queueTail.load(std::memory_order_acquire)) {
+    armTimerFor(noteQueue[next % AUDIO_QUEUE_LENGTH]);
+  } else {
+    // loop() hasn't decoded the next note yet; it re-arms us when it does
+    timerArmed.store(false, std::memory_order_release);
+    armIfIdle();
+  }
+}
+
+void audioBegin(uint8_t buzzerPin) {
+  buzzer = buzzerPin;
+  esp_timer_create_args_t args = {};
+  args.callback = onNoteTimer;
+  args.name = "song";
+  esp_timer_create(&args, &noteTimer);
+}
+
+void audioStart(const Song& newSong) {
+  audioStop();
+
+  decoder.begin(newSong.notes);
+  endQueued = false;
+  nextOnsetMs = 0;
+  songFinished.store(false, std::memory_order_release);
+
+  // Small lead so the first notes are queued before the first one is due
+  songStartUs = esp_timer_get_time() + 5000;
+  audioFill();
+}
+
+void audioStop() {
+  esp_timer_stop(noteTimer);
+  timerArmed.store(false, std::memory_order_release);
+  queueHead.store(0, std::memory_order_relaxed);
+  queueTail.store(0, std::memory_order_relaxed);
+  songFinished.store(true, std::memory_order_release);
+  noTone(buzzer);
+}
+
+void audioSetDuty(uint8_t percent) {
+  duty = percent == 0 ? 1 : percent > 100 ? 100 : percent;
+}
+
+void audioFill() {
+  if (songFinished.load(std::memory_order_acquire)) return;
+
+  uint16_t tail = queueTail.load(std::memory_order_relaxed);
+  while (!endQueued && (uint16_t)(tail - queueHead.load(std::memory_order_acquire)) < AUDIO_QUEUE_LENGTH) {
+    QueuedNote& note = noteQueue[tail % AUDIO_QUEUE_LENGTH];
+
+    // Notes come out of the packed song ready to play (song_compiler.h)
+    CompiledNote compiled;
+    note.onsetMs = nextOnsetMs;
+    if (decoder.next(compiled)) {
+      note.frequency = compiled.frequency;
+      note.toneMs = compiled.toneMs;
+      if (duty < 100 && note.toneMs) {
+        // tone() with a duration of 0 would never stop
+        note.toneMs = (uint16_t)((uint32_t)note.toneMs * duty / 100);
+        if (note.toneMs == 0) note.toneMs = 1;
+      }
+      note.last = false;
+      nextOnsetMs += compiled.durationMs;
+    } else {
+      note.frequency = 0;
+      note.toneMs = 0;
+      note.last = true;
+      endQueued = true;
+    }
+
+    tail++;
+    queueTail.store(tail, std::memory_order_release);
+  }
+
+  armIfIdle();
+}
+
+bool audioFinished() {
+  return songFinished.load(std::memory_order_acquire);
+}
+
+const AudioStats& audioStats() {
+  return stats;
+}
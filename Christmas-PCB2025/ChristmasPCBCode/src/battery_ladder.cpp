@@ -0,0 +1,87 @@
+#include "battery_ladder.h"
+
+static const BatteryStep steps[NUM_BATTERY_LEVELS] = {
+  // name     belowMv           brightness slowdown duty wifi
+  {"ok",      0,                255,       1,       100, true},
+  {"save",    LADDER_SAVE_MV,   40,        2,       50,  true},
+  {"low",     LADDER_LOW_MV,    25,        4,       25,  false},
+  {"glow",    LADDER_GLOW_MV,   8,         8,       0,   false},
+  {"empty",   LADDER_EMPTY_MV,  8,         8,       0,   false}
+};
+
+static BatteryLevel level = BATTERY_OK;
+static uint32_t stepsDown = 0;
+static uint32_t stepsUp = 0;
+static uint32_t levelSince = 0;  // millis()
+
+static void logStep(uint16_t millivolts) {
+  const BatteryStep& step = steps[level];
+  Serial.print("Battery ladder: ");
+  Serial.print(step.name);
+  Serial.print(" at ");
+  Serial.print(millivolts);
+  Serial.print(" mV - brightness <= ");
+  Serial.print(step.maxBrightness);
+  Serial.print(", patterns 1/");
+  Serial.print(step.frameSlowdown);
+  Serial.print(" speed, songs ");
+  if (step.songDuty) {
+    Serial.print(step.songDuty);
+    Serial.print("% duty");
+  } else {
+    Serial.print("off");
+  }
+  Serial.print(", WiFi ");
+  Serial.println(step.wifi ? "allowed" : "off");
+}
+
+void ladderBegin() {
+  level = BATTERY_OK;
+  stepsDown = 0;
+  stepsUp = 0;
+  levelSince = millis();
+}
+
+BatteryLevel ladderUpdate(bool onBattery, uint16_t millivolts) {
+  BatteryLevel next = level;
+  if (!onBattery) {
+    next = BATTERY_OK;
+  } else {
+    while (next < BATTERY_EMPTY && millivolts < steps[next + 1].belowMv) next = (BatteryLevel)(next + 1);
+    while (next > BATTERY_OK && millivolts >= steps[next].belowMv + LADDER_HYSTERESIS_MV) next = (BatteryLevel)(next - 1);
+  }
+  if (next == level) return level;
+
+  if (next > level) {
+    stepsDown++;
+  } else {
+    stepsUp++;
+  }
+  level = next;
+  levelSince = millis();
+  logStep(millivolts);
+  return level;
+}
+
+BatteryLevel ladderLevel() {
+  return level;
+}
+
+const BatteryStep& ladderStep() {
+  return steps[level];
+}
+
+void ladderPrintStats() {
+  uint32_t minutes = (millis() - levelSince) / 60000;
+  Serial.print("Battery ladder: ");
+  Serial.print(steps[level].name);
+  Serial.print(" for ");
+  Serial.print(minutes / 60);
+  Serial.print("h ");
+  Serial.print(minutes % 60);
+  Serial.print("m; ");
+  Serial.print(stepsDown);
+  Serial.print(" steps down, ");
+  Serial.print(stepsUp);
+  Serial.println(" up");
+}
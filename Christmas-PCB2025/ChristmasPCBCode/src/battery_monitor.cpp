@@ -0,0 +1,47 @@
+#include "battery_monitor.h"
+
+static uint8_t sensePin = 0;
+static uint32_t filtered = 0;  // millivolts << 4
+static BatteryStats stats;
+
+static uint16_t burst(uint8_t samples) {
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < samples; i++) sum += analogReadMilliVolts(sensePin);
+  return (uint16_t)((sum + samples / 2) / samples);
+}
+
+static void track(uint16_t millivolts) {
+  if (stats.bursts == 0 || millivolts < stats.minMv) stats.minMv = millivolts;
+  if (stats.bursts == 0 || millivolts > stats.maxMv) stats.maxMv = millivolts;
+  stats.bursts++;
+}
+
+void batteryBegin(uint8_t pin) {
+  sensePin = pin;
+  uint16_t millivolts = burst(BATTERY_SEED_SAMPLES);
+  stats.lastBurstMv = millivolts;
+  filtered = (uint32_t)millivolts << 4;
+  track(millivolts);
+}
+
+void batterySample() {
+  uint16_t millivolts = burst(BATTERY_OVERSAMPLE);
+  stats.lastBurstMv = millivolts;
+
+  int32_t step = (int32_t)millivolts - (int32_t)batteryMillivolts();
+  if (step > BATTERY_STEP_MV || step < -BATTERY_STEP_MV) {
+    filtered = (uint32_t)millivolts << 4;
+    stats.resets++;
+  } else {
+    filtered += ((int32_t)((uint32_t)millivolts << 4) - (int32_t)filtered) >> BATTERY_IIR_SHIFT;
+  }
+  track(batteryMillivolts());
+}
+
+uint16_t batteryMillivolts() {
+  return (uint16_t)((filtered + 8) >> 4);
+}
+
+const BatteryStats& batteryStats() {
+  return stats;
+}
@@ -0,0 +1,289 @@
+#include "fuel_gauge.h"
+#include "patterns.h"
+#include "power_manager.h"
+#include <sys/time.h>
+
+// Current model, in uA from the cells. LED figures are for a WS2812B at the
+// cells' voltage: per channel at 255, and the idle draw of each LED's driver.
+const uint32_t LED_CHANNEL_MICROAMPS = 12000;
+const uint32_t LED_IDLE_MICROAMPS = 600;
+const uint32_t WIFI_AP_MICROAMPS = 90000;   // radio, on top of the CPU at 160 MHz
+const uint32_t BUZZER_MICROAMPS = 15000;    // square wave into the buzzer
+const uint32_t DEEP_SLEEP_MICROAMPS = 5;    // chip only
+// Peaks, for the LED power budget
+const uint32_t CHIP_PEAK_MICROAMPS = 25000;        // 160 MHz
+const uint32_t WIFI_TX_PEAK_MICROAMPS = 300000;    // a beacon or reply going out
+
+const uint64_t UAMS_PER_MAH = 3600000000ULL;
+const uint64_t CAPACITY_UAMS = FUEL_CAPACITY_MAH * UAMS_PER_MAH;
+
+// 2x AAA alkaline at a light load, as read on the sense pin (the divider puts
+// 3.2 V of fresh cells at the top of the ADC range)
+struct CurvePoint {
+  uint16_t millivolts;
+  uint16_t permille;
+};
+static const CurvePoint curve[] = {
+  {2750, 1000}, {2558, 900}, {2365, 700}, {2231, 500}, {2077, 300},
+  {1923, 150}, {1788, 70}, {1596, 20}, {1500, 0}
+};
+const uint8_t CURVE_POINTS = sizeof(curve) / sizeof(curve[0]);
+
+// The count moves 1/VOLTAGE_PULL of the way to the voltage per update (10 s),
+// a time constant of about three hours, so load sags and the cells' recovery
+// average out. The voltage being this far above the count means new batteries.
+const int32_t VOLTAGE_PULL = 1024;
+const int32_t REPLACED_PERMILLE = 400;
+const uint8_t DRAW_SHIFT = 2;  // draw averages move 1/4 of the way per update
+const uint32_t SECONDS_PER_DAY = 86400;
+
+// Kept across resets and deep sleep; the magic tells it from power-on garbage
+#define RTC_FUEL_MAGIC 0x4655454C
+struct RtcFuel {
+  uint32_t magic;
+  uint32_t check;
+  uint64_t consumed;     // uA*ms
+  int64_t atUs;          // RTC clock when consumed was counted
+  uint32_t litMicroamps;
+};
+RTC_NOINIT_ATTR static RtcFuel rtcFuel;
+
+static uint64_t consumed = 0;          // uA*ms
+static bool voltageChecked = false;    // false until the first reading after a power loss
+static bool onBatteryNow = false;
+static uint16_t voltagePermille = 1000;
+static uint32_t lastUpdate = 0;        // millis()
+static uint64_t chipCharge = 0;        // powerCharge() at the last update
+static uint32_t frameMicroamps = NUM_LEDS * LED_IDLE_MICROAMPS;
+static bool frameLit = false;
+static uint32_t frameSince = 0;        // millis() of the last frame or update
+static uint64_t ledCharge = 0;         // uA*ms since the last update
+static uint32_t litMs = 0;             // of the time since the last update
+static uint32_t drawMicroamps = 0;     // everything, recent
+static uint32_t litMicroamps = 0;      // lit patterns without WiFi or a song
+
+// The RTC timer keeps this clock running through deep sleep
+static int64_t rtcMicros() {
+  struct timeval now;
+  gettimeofday(&now, nullptr);
+  return (int64_t)now.tv_sec * 1000000 + now.tv_usec;
+}
+
+static uint32_t rtcCheck() {
+  return ~((uint32_t)rtcFuel.consumed ^ (uint32_t)(rtcFuel.consumed >> 32) ^
+           (uint32_t)rtcFuel.atUs ^ (uint32_t)(rtcFuel.atUs >> 32) ^ rtcFuel.litMicroamps);
+}
+
+static void saveRtc() {
+  rtcFuel.consumed = consumed;
+  rtcFuel.atUs = rtcMicros();
+  rtcFuel.litMicroamps = litMicroamps;
+  rtcFuel.check = rtcCheck();
+  rtcFuel.magic = RTC_FUEL_MAGIC;
+}
+
+static uint16_t curvePermille(uint16_t millivolts) {
+  if (millivolts >= curve[0].millivolts) return curve[0].permille;
+  for (uint8_t i = 1; i < CURVE_POINTS; i++) {
+    if (millivolts < curve[i].millivolts) continue;
+    const CurvePoint& high = curve[i - 1];
+    const CurvePoint& low = curve[i];
+    return low.permille + (uint32_t)(millivolts - low.millivolts) * (high.permille - low.permille) /
+                          (high.millivolts - low.millivolts);
+  }
+  return 0;
+}
+
+static uint16_t countPermille() {
+  return (uint16_t)((CAPACITY_UAMS - consumed) * 1000 / CAPACITY_UAMS);
+}
+
+static uint64_t remainingCharge() {
+  return CAPACITY_UAMS - consumed;
+}
+
+static void average(uint32_t& value, uint32_t sample) {
+  if (value == 0) {
+    value = sample;
+  } else {
+    value = (uint32_t)((int32_t)value + (((int32_t)sample - (int32_t)value) >> DRAW_SHIFT));
+  }
+}
+
+static uint32_t channelSum(const CRGB* leds, uint16_t count) {
+  uint32_t channels = 0;
+  for (uint16_t i = 0; i < count; i++) channels += leds[i].r + leds[i].g + leds[i].b;
+  return channels;
+}
+
+static uint32_t stripMicroamps(uint32_t channels, uint16_t count, uint8_t brightness) {
+  return count * LED_IDLE_MICROAMPS + (uint32_t)((uint64_t)channels * brightness * LED_CHANNEL_MICROAMPS / (255 * 255));
+}
+
+static void countLeds(uint32_t now) {
+  uint32_t span = now - frameSince;
+  ledCharge += (uint64_t)span * frameMicroamps;
+  if (frameLit) litMs += span;
+  frameSince = now;
+}
+
+void fuelBegin(uint16_t savedMah) {
+  if (rtcFuel.magic == RTC_FUEL_MAGIC && rtcFuel.check == rtcCheck()) {
+    // Reset or deep sleep: the LEDs were dark, only their drivers drew
+    int64_t slept = rtcMicros() - rtcFuel.atUs;
+    consumed = rtcFuel.consumed;
+    if (slept > 0) consumed += (uint64_t)(slept / 1000) * (DEEP_SLEEP_MICROAMPS + NUM_LEDS * LED_IDLE_MICROAMPS);
+    litMicroamps = rtcFuel.litMicroamps;
+    voltageChecked = true;
+  } else {
+    consumed = (uint64_t)savedMah * UAMS_PER_MAH;
+    litMicroamps = 0;
+    voltageChecked = false;
+  }
+  if (consumed > CAPACITY_UAMS) consumed = CAPACITY_UAMS;
+
+  uint32_t now = millis();
+  lastUpdate = now;
+  frameSince = now;
+  chipCharge = powerCharge();
+  frameMicroamps = NUM_LEDS * LED_IDLE_MICROAMPS;
+  frameLit = false;
+  ledCharge = 0;
+  litMs = 0;
+  drawMicroamps = 0;
+  saveRtc();
+}
+
+void fuelFrame(const CRGB* leds, uint16_t count, uint8_t brightness) {
+  countLeds(millis());
+
+  uint32_t channels = channelSum(leds, count);
+  frameMicroamps = stripMicroamps(channels, count, brightness);
+  frameLit = channels > 0 && brightness > 0;
+}
+
+void fuelUpdate(bool onBattery, bool wifi, bool buzzer, uint16_t millivolts) {
+  uint32_t now = millis();
+  countLeds(now);
+  uint32_t elapsed = now - lastUpdate;
+  uint64_t chip = powerCharge();
+
+  uint64_t charge = chip - chipCharge + ledCharge;
+  if (wifi) charge += (uint64_t)elapsed * WIFI_AP_MICROAMPS;
+  if (buzzer) charge += (uint64_t)elapsed * BUZZER_MICROAMPS;
+  bool lit = elapsed > 0 && litMs == elapsed;
+
+  lastUpdate = now;
+  chipCharge = chip;
+  ledCharge = 0;
+  litMs = 0;
+
+  // The draw is tracked on USB too, so patterns can be compared while plugged in
+  if (elapsed > 0) {
+    uint32_t draw = (uint32_t)(charge / elapsed);
+    average(drawMicroamps, draw);
+    if (lit && !wifi && !buzzer) average(litMicroamps, draw);
+  }
+
+  onBatteryNow = onBattery;
+  if (onBattery) {
+    consumed += charge;
+    if (consumed > CAPACITY_UAMS) consumed = CAPACITY_UAMS;
+
+    voltagePermille = curvePermille(millivolts);
+    int32_t gap = (int32_t)voltagePermille - (int32_t)countPermille();
+    int64_t target = (int64_t)(CAPACITY_UAMS * (1000 - voltagePermille) / 1000);
+    if (gap > REPLACED_PERMILLE || (!voltageChecked && gap < -REPLACED_PERMILLE)) {
+      consumed = (uint64_t)target;
+      Serial.println(voltageChecked ? "Fuel gauge: new batteries" : "Fuel gauge: count reset from the voltage");
+    } else {
+      consumed = (uint64_t)((int64_t)consumed + (target - (int64_t)consumed) / VOLTAGE_PULL);
+    }
+    voltageChecked = true;
+  }
+  saveRtc();
+}
+
+uint32_t fuelPeakMicroamps(bool wifi, bool buzzer) {
+  uint32_t peak = CHIP_PEAK_MICROAMPS;
+  if (wifi) peak += WIFI_TX_PEAK_MICROAMPS;
+  if (buzzer) peak += BUZZER_MICROAMPS;
+  return peak;
+}
+
+uint8_t fuelLimitBrightness(const CRGB* leds, uint16_t count, uint8_t brightness,
+                            uint32_t otherMicroamps, uint32_t budgetMicroamps) {
+  uint32_t channels = channelSum(leds, count);
+  if (channels == 0 || otherMicroamps + stripMicroamps(channels, count, brightness) <= budgetMicroamps) {
+    return brightness;
+  }
+  uint32_t idle = count * LED_IDLE_MICROAMPS;
+  if (budgetMicroamps <= otherMicroamps + idle) return 0;
+  uint64_t allowed = (uint64_t)(budgetMicroamps - otherMicroamps - idle) * (255 * 255) /
+                     ((uint64_t)channels * LED_CHANNEL_MICROAMPS);
+  return allowed < brightness ? (uint8_t)allowed : brightness;
+}
+
+uint16_t fuelConsumedMah() {
+  return (uint16_t)(consumed / UAMS_PER_MAH);
+}
+
+uint8_t fuelPercent() {
+  return (uint8_t)((countPermille() + 5) / 10);
+}
+
+uint32_t fuelMinutesRemaining() {
+  if (drawMicroamps == 0) return 0;
+  return (uint32_t)(remainingCharge() / drawMicroamps / 60000);
+}
+
+// Tenths, as "12.3"
+static void printTenths(uint64_t tenths) {
+  Serial.print((unsigned long)(tenths / 10));
+  Serial.print(".");
+  Serial.print((unsigned long)(tenths % 10));
+}
+
+void fuelPrintStats(uint32_t onSeconds, uint32_t cycleSeconds) {
+  Serial.print("Fuel: ");
+  Serial.print((unsigned long)(remainingCharge() / UAMS_PER_MAH));
+  Serial.print(" of ");
+  Serial.print(FUEL_CAPACITY_MAH);
+  Serial.print(" mAh left (");
+  Serial.print(fuelPercent());
+  if (onBatteryNow) {
+    Serial.print("%, voltage says ");
+    Serial.print((voltagePermille + 5) / 10);
+    Serial.print("%)");
+  } else {
+    Serial.print("%, on USB)");
+  }
+
+  if (drawMicroamps > 0) {
+    uint32_t minutes = fuelMinutesRemaining();
+    Serial.print(", drawing ~");
+    printTenths(drawMicroamps / 100);
+    Serial.print(" mA: ");
+    Serial.print(minutes / 60);
+    Serial.print("h ");
+    Serial.print(minutes % 60);
+    Serial.print("m at this rate");
+  }
+
+  if (litMicroamps > 0 && cycleSeconds > onSeconds) {
+    // Lit for onSeconds, deep sleep with the LEDs' idle draw for the rest
+    uint64_t perCycle = ((uint64_t)litMicroamps * onSeconds +
+                         (uint64_t)(DEEP_SLEEP_MICROAMPS + NUM_LEDS * LED_IDLE_MICROAMPS) * (cycleSeconds - onSeconds)) * 1000;
+    uint64_t alwaysOnPerDay = (uint64_t)litMicroamps * SECONDS_PER_DAY * 1000;
+    Serial.print("; lit patterns ~");
+    printTenths(litMicroamps / 100);
+    Serial.print(" mA: ");
+    printTenths(remainingCharge() * 10 * cycleSeconds / (perCycle * SECONDS_PER_DAY));
+    Serial.print(" days on the ");
+    Serial.print(onSeconds / 3600);
+    Serial.print("h timer, ");
+    printTenths(remainingCharge() * 10 / alwaysOnPerDay);
+    Serial.print(" days always on");
+  }
+  Serial.println();
+}
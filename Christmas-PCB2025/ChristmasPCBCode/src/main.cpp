@@ -1,23 +1,29 @@
 #include <Arduino.h>
 #include <FastLED.h>
-#include <Preferences.h>
 #include <WiFi.h>
-#include <WebServer.h>
 #include <DNSServer.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
 #include "christmas_songs.h"
-
-Preferences preferences;
-
-// Web server and DNS
-WebServer server(80);
+#include "scheduler.h"
+#include "audio_engine.h"
+#include "battery_ladder.h"
+#include "battery_monitor.h"
+#include "fuel_gauge.h"
+#include "patterns.h"
+#include "power_manager.h"
+#include "settings_store.h"
+#include "web_portal.h"
+
+// DNS for the captive portal (the web server is in web_portal.cpp)
 DNSServer dnsServer;
 bool wifiAPEnabled = false;
 const byte DNS_PORT = 53;
-unsigned long lastClientConnectTime = 0;
+uint32_t lastClientConnectTime = 0;
 
 // WiFi timeout variables
-unsigned long wifiAPStartTime = 0;
-const unsigned long WIFI_TIMEOUT = 300000; // 5 minutes in milliseconds
+uint32_t wifiAPStartTime = 0;
+const uint32_t WIFI_TIMEOUT = 300000; // 5 minutes in milliseconds
 bool wifiTimeoutEnabled = true;
 
 // Hardware Configuration
@@ -27,18 +33,24 @@ bool wifiTimeoutEnabled = true;
 #define BUTTON2 5
 #define BATT_SENSE 0
 #define LDR_PIN 2
-#define NUM_LEDS 8
 #define TOP_LED 7
 
-// Battery voltage thresholds
-#define BATT_AAA_MIN 1.5
-#define BATT_AAA_MAX 2.75
-#define BATT_NO_DETECT 0.5
+// Battery voltage thresholds (mV on the sense pin)
+#define BATT_AAA_MIN_MV 1500
+#define BATT_AAA_MAX_MV 2750
+#define BATT_NO_DETECT_MV 500
+#define BATT_SETTLE_US 500  // after blanking the LEDs, before the ADC burst
 
 // Brightness levels
 #define BRIGHTNESS_USB 60
 #define BRIGHTNESS_BATTERY 60
 
+// Supply current ceilings (mA): each frame is dimmed so the strip, the chip,
+// WiFi TX bursts and the buzzer stay below them together. Sagging AAA cells
+// brown the C3 out long before USB runs short.
+#define POWER_BUDGET_USB_MA 500
+#define POWER_BUDGET_BATTERY_MA 350
+
 // Timer Configuration
 #define TIMER_ON_DURATION 21600
 #define TIMER_CYCLE_DURATION 86400
@@ -46,21 +58,30 @@ bool wifiTimeoutEnabled = true;
 // LED Array
 CRGB leds[NUM_LEDS];
 
+// Frame tracking: everything that writes leds[] bumps frameVersion, and
+// showFrame() only sends a frame to the strip when it (or the brightness) changed
+uint32_t frameVersion = 0;
+uint32_t shownFrameVersion = 0xFFFFFFFF;
+uint8_t shownBrightness = 0;
+uint32_t framesShown = 0;
+uint32_t framesSkipped = 0;
+uint32_t framesLimited = 0;  // dimmed by the power budget
+
 // Button Handling
 bool button1State = HIGH;
 bool lastButton1State = HIGH;
 bool button2State = HIGH;
 bool lastButton2State = HIGH;
-unsigned long lastDebounceTime = 0;
-unsigned long debounceDelay = 50;
-unsigned long button1PressStartTime = 0;
+uint32_t lastDebounceTime = 0;
+uint32_t debounceDelay = 50;
+uint32_t button1PressStartTime = 0;
 bool button1LongPressDetected = false;
-const unsigned long longPressTime = 2000;
+const uint32_t longPressTime = 2000;
 
 // WiFi easter egg
 bool bothButtonsPressed = false;
-unsigned long bothButtonsPressStart = 0;
-const unsigned long bothButtonsHoldTime = 1000;
+uint32_t bothButtonsPressStart = 0;
+const uint32_t bothButtonsHoldTime = 1000;
 bool wifiMessageSent = false;
 
 // Power Management
@@ -71,15 +92,16 @@ enum PowerSource {
 PowerSource currentPowerSource = POWER_USB;
 int currentBrightness = BRIGHTNESS_USB;
 
-// Settings Management
+// Settings Management: changes are batched into one commit per saveInterval,
+// which writes the settings blob only if something changed (settings_store.cpp)
 bool settingsChanged = false;
-unsigned long lastSaveTime = 0;
-const unsigned long saveInterval = 30000;
+uint32_t lastSaveTime = 0;
+const uint32_t saveInterval = 30000;
+uint16_t savedConsumedMah = 0;  // fuel gauge count in the settings, in FUEL_SAVE_STEP_MAH steps
 
-// Uptime tracking
+// Uptime tracking (RTC memory and the uptime log, see settings_store.h)
 uint32_t totalUptimeLow = 0;
 uint32_t totalUptimeHigh = 0;
-unsigned long lastMillisCheck = 0;
 
 // Timer System
 bool timerEnabled = false;
@@ -87,28 +109,19 @@ uint32_t cycleStartUptimeLow = 0;
 uint32_t cycleStartUptimeHigh = 0;
 bool manualOverride = false;
 
+// Deep sleep through the timer OFF phase, on batteries: the board wakes up by
+// timer at the next ON phase, or by a button for a manual override
+const uint32_t DEEP_SLEEP_DELAY = 30000;  // ms awake after power-on or a button
+const uint32_t DEEP_SLEEP_MIN = 60;       // s; shorter waits are left to light sleep
+uint32_t deepSleepAllowedAt = 0;
+
 // Mode indicator animation
 bool showingModeIndicator = false;
-unsigned long modeIndicatorStartTime = 0;
-const unsigned long MODE_INDICATOR_DURATION = 2000;
+uint32_t modeIndicatorStartTime = 0;
+const uint32_t MODE_INDICATOR_DURATION = 2000;
 CRGB savedLedsBeforeIndicator[NUM_LEDS];
 
-// Display Mode Enum
-enum DisplayMode {
-  STATIC_COLOR,
-  RANDOM_SCATTER,
-  RAINBOW_MODE,
-  SNAKE_MODE,
-  RANDOM_BLINK,
-  CHASE_MODE,
-  WAVE_MODE,
-  FADE_RANDOM,
-  SPARKLE_MODE,
-  FIREWORK_MODE,
-  METEOR_MODE,
-  CANDY_CANE_MODE,
-  OFF_MODE
-};
+// Display Mode (see patterns.h)
 DisplayMode currentMode = STATIC_COLOR;
 
 // Color Options
@@ -121,52 +134,7 @@ CRGB colorOptions[] = {
 #define NUM_COLORS (sizeof(colorOptions) / sizeof(colorOptions[0]))
 
 // Pattern Variables
-unsigned long lastPatternUpdate = 0;
-unsigned long patternUpdateInterval = 50;
-
-const unsigned long RAINBOW_SPEED = 600;
-const unsigned long SNAKE_SPEED = 800;
-const unsigned long CHASE_SPEED = 720;
-const unsigned long WAVE_SPEED = 480;
-const unsigned long FADE_SPEED = 200;
-const unsigned long SCATTER_SPEED = 1000;
-const unsigned long SPARKLE_SPEED = 200;
-const unsigned long FIREWORK_SPEED = 400;
-const unsigned long METEOR_SPEED = 200;
-const unsigned long CANDY_SPEED = 600;
-
-uint8_t fadeProgress = 0;
-CRGB currentFadeColors[NUM_LEDS];
-CRGB targetFadeColors[NUM_LEDS];
-bool needNewFadeTarget = true;
-
-uint8_t snakeHeadPos = 0;
-const uint8_t snakeLength = 3;
-
-uint8_t randomLEDs[3] = {0};
-unsigned long lastRandomUpdate = 0;
-
-uint8_t chasePos = 0;
-uint8_t waveOffset = 0;
-
-uint8_t sparklePositions[NUM_LEDS];
-uint8_t sparkleBrightness[NUM_LEDS];
-uint8_t sparkleColors[NUM_LEDS];
-
-struct Firework {
-  int8_t position;
-  uint8_t phase;
-  uint8_t brightness;
-  bool isRed;
-};
-Firework currentFirework = {-1, 0, 0, true};
-
-int8_t meteorPos = -1;
-uint8_t meteorTail[3];
-bool meteorIsRed = true;
-
-uint8_t candyOffset = 0;
-const uint8_t stripeWidth = 2;
+uint32_t lastPatternUpdate = 0;
 
 // Song State
 enum SongState {
@@ -177,388 +145,35 @@ SongState songState = IDLE;
 ChristmasSong currentSong = SANTA_CLAUS_IS_COMIN;
 Song currentSongData;
 
-unsigned long lastNoteTime = 0;
-uint16_t currentNote = 0;
-uint16_t currentNoteDuration = 0;
-
 // Monitoring
-unsigned long lastBatteryCheck = 0;
-unsigned long lastSensorOutput = 0;
-const unsigned long batteryCheckInterval = 10000;
-
-// HTML page for captive portal with controls - Christmas themed with snowflakes
-const char htmlPage1[] PROGMEM = R"rawliteral(
-<!DOCTYPE html>
-<html>
-<head>
-<meta charset="UTF-8">
-<meta name="viewport" content="width=device-width, initial-scale=1.0">
-<title>Christmas PCB Control</title>
-<style>
-body {
-  margin: 0;
-  padding: 20px;
-  font-family: 'Arial', sans-serif;
-  background: linear-gradient(135deg, #1a2a1a 0%, #0d1f0d 100%);
-  color: #fff;
-  overflow-x: hidden;
-  position: relative;
-  min-height: 100vh;
-}
-
-/* Snowflakes */
-.snowflake {
-  position: absolute;
-  top: -10px;
-  color: #ffffff;
-  font-size: 1em;
-  user-select: none;
-  pointer-events: none;
-  animation-name: fall;
-  animation-timing-function: linear;
-  animation-iteration-count: infinite;
-}
-
-@keyframes fall {
-  to {
-    transform: translateY(100vh) rotate(360deg);
-  }
-}
-
-.container {
-  max-width: 500px;
-  margin: 0 auto;
-  background: rgba(139, 0, 0, 0.15);
-  border-radius: 15px;
-  padding: 20px;
-  backdrop-filter: blur(10px);
-  border: 2px solid #8B0000;
-  box-shadow: 0 8px 32px rgba(139, 0, 0, 0.3);
-  position: relative;
-  z-index: 1;
-}
-
-h1 {
-  text-align: center;
-  font-size: 2.2em;
-  margin: 0 0 20px 0;
-  color: #ff6b6b;
-  text-shadow: 0 2px 4px rgba(0, 0, 0, 0.5);
-  background: linear-gradient(45deg, #ff6b6b, #ffd93d);
-  -webkit-background-clip: text;
-  -webkit-text-fill-color: transparent;
-  background-clip: text;
-}
-
-.greeting {
-  text-align: center;
-  font-size: 1.3em;
-  margin: 20px 0;
-  padding: 15px;
-  background: rgba(34, 139, 34, 0.3);
-  border-radius: 10px;
-  border: 1px solid #228B22;
-  color: #90EE90;
-  font-weight: bold;
-}
-
-.control-group {
-  margin: 20px 0;
-  padding: 15px;
-  background: rgba(34, 139, 34, 0.2);
-  border-radius: 10px;
-  border: 1px solid #228B22;
-}
-
-.control-group label {
-  display: block;
-  margin-bottom: 8px;
-  font-weight: bold;
-  color: #ffd93d;
-}
-
-select, input[type=range] {
-  width: 100%;
-  padding: 10px;
-  border-radius: 8px;
-  border: 2px solid #8B0000;
-  background: rgba(255, 255, 255, 0.95);
-  color: #2d5016;
-  font-size: 16px;
-  transition: all 0.3s ease;
-}
-
-select:focus, input[type=range]:focus {
-  outline: none;
-  border-color: #ff6b6b;
-  box-shadow: 0 0 10px rgba(255, 107, 107, 0.5);
-}
-
-input[type=range] {
-  padding: 0;
-  height: 25px;
-  background: linear-gradient(to right, #228B22, #ff6b6b);
-}
-
-input[type=range]::-webkit-slider-thumb {
-  appearance: none;
-  width: 25px;
-  height: 25px;
-  border-radius: 50%;
-  background: #ffd93d;
-  border: 2px solid #8B0000;
-  cursor: pointer;
-}
-
-.value-display {
-  text-align: center;
-  font-size: 1.2em;
-  margin-top: 5px;
-  color: #ffd93d;
-  font-weight: bold;
-}
-
-button {
-  width: 100%;
-  padding: 14px;
-  margin: 10px 0;
-  border: none;
-  border-radius: 10px;
-  font-size: 16px;
-  font-weight: bold;
-  cursor: pointer;
-  transition: all 0.3s ease;
-  text-transform: uppercase;
-  letter-spacing: 1px;
-}
-
-button:hover {
-  transform: translateY(-2px);
-  box-shadow: 0 5px 15px rgba(0, 0, 0, 0.3);
-}
-
-button:active {
-  transform: translateY(0);
-}
-
-.btn-apply {
-  background: linear-gradient(45deg, #228B22, #32CD32);
-  color: white;
-  border: 2px solid #006400;
-}
-
-.btn-song {
-  background: linear-gradient(45deg, #8B0000, #FF0000);
-  color: white;
-  border: 2px solid #800000;
-}
-
-.status {
-  text-align: center;
-  padding: 12px;
-  margin: 10px 0;
-  background: rgba(255, 215, 0, 0.2);
-  border-radius: 8px;
-  font-size: 0.9em;
-  border: 1px solid #FFD700;
-  color: #FFD700;
-}
-
-.christmas-header {
-  text-align: center;
-  font-size: 3em;
-  margin-bottom: 10px;
-  animation: glow 2s ease-in-out infinite alternate;
-}
-
-@keyframes glow {
-  from {
-    text-shadow: 0 0 10px #ff0000, 0 0 20px #ff0000, 0 0 30px #ff6b6b;
-  }
-  to {
-    text-shadow: 0 0 20px #00ff00, 0 0 30px #00ff00, 0 0 40px #90ee90;
-  }
-}
-
-.ornament {
-  display: inline-block;
-  margin: 0 10px;
-  animation: bounce 2s infinite;
-}
-
-@keyframes bounce {
-  0%, 100% { transform: translateY(0); }
-  50% { transform: translateY(-10px); }
-}
-
-.battery-info {
-  text-align: center;
-  padding: 10px;
-  margin: 10px 0;
-  background: rgba(255, 255, 255, 0.1);
-  border-radius: 8px;
-  border: 1px solid #ffd93d;
-  color: #ffd93d;
-  font-size: 0.9em;
-}
-</style>
-</head>
-<body>
-<div id="snowflakes"></div>
-
-<div class="container">
-  <div class="christmas-header">
-    Christmas BALL PCB
-  </div>
-  
-  <h1>Control Panel</h1>
-  <div class="greeting">Fijne kerst Casper! 🎅</div>
-
-  <div class="control-group">
-    <label>✨ Brightness</label>
-    <input type="range" id="brightness" min="10" max="255" value="60" oninput="updateBrightness(this.value)">
-    <div class="value-display" id="brightnessVal">60</div>
-  </div>
-
-  <div class="control-group">
-    <label>🎨 LED Pattern</label>
-    <select id="pattern">
-)rawliteral";
-
-const char htmlPage2[] PROGMEM = R"rawliteral(
-      <option value="0">Static Red</option>
-      <option value="1">Static Green</option>
-      <option value="2">Random Scatter</option>
-      <option value="3">Rainbow</option>
-      <option value="4">Snake</option>
-      <option value="5">Random Blink</option>
-      <option value="6">Chase</option>
-      <option value="7">Wave</option>
-      <option value="8">Fade Random</option>
-      <option value="9">Sparkle</option>
-      <option value="10">Firework</option>
-      <option value="11">Meteor</option>
-      <option value="12">Candy Cane</option>
-      <option value="13">Off</option>
-    </select>
-  </div>
-
-  <div class="control-group">
-    <label>⏰ 6-Hours-ON Timer</label>
-    <select id="timer">
-      <option value="0">Disabled</option>
-      <option value="1">Enabled</option>
-    </select>
-  </div>
-
-  <button class="btn-apply" onclick="applySettings()">Apply Settings</button>
-
-  <div class="control-group">
-    <label>🎵 Play Christmas Song</label>
-    <select id="song">
-      <option value="0">Santa Claus Is Coming</option>
-      <option value="1">Jingle Bells</option>
-      <option value="2">We Wish You Merry Xmas</option>
-      <option value="3">Silent Night</option>
-      <option value="4">Rudolph</option>
-      <option value="5">O Christmas Tree</option>
-      <option value="6">O Come All Ye Faithful</option>
-      <option value="7">O Little Town</option>
-      <option value="8">The First Noel</option>
-      <option value="9">We Three Kings</option>
-      <option value="10">White Christmas</option>
-      <option value="11">Away in a Manger</option>
-      <option value="12">Carol of the Bells</option>
-      <option value="13">Deck the Halls</option>
-      <option value="14">God Rest Ye</option>
-      <option value="15">Go Tell It</option>
-      <option value="16">Hark the Herald</option>
-      <option value="17">Joy to the World</option>
-    </select>
-    <button class="btn-song" onclick="playSong()">Play Song 🎶</button>
-    <button class="btn-song" onclick="stopSong()">Stop Song ⏹️</button>
-  </div>
-
-  <div class="status" id="status">Ready to spread Christmas cheer! 🎄</div>
-</div>
-
-<script>
-// Snowflake animation
-function createSnowflakes() {
-  const snowflakesContainer = document.getElementById('snowflakes');
-  const snowflakes = ['❄', '❅', '❆', '•'];
-  
-  for (let i = 0; i < 50; i++) {
-    const snowflake = document.createElement('div');
-    snowflake.className = 'snowflake';
-    snowflake.textContent = snowflakes[Math.floor(Math.random() * snowflakes.length)];
-    snowflake.style.left = Math.random() * 100 + 'vw';
-    snowflake.style.animationDuration = (Math.random() * 5 + 5) + 's';
-    snowflake.style.animationDelay = Math.random() * 5 + 's';
-    snowflake.style.opacity = Math.random() * 0.7 + 0.3;
-    snowflake.style.fontSize = (Math.random() * 10 + 10) + 'px';
-    snowflakesContainer.appendChild(snowflake);
-  }
-}
-
-function updateBrightness(val) {
-  document.getElementById('brightnessVal').innerText = val;
-}
-
-function applySettings() {
-  var b = document.getElementById('brightness').value;
-  var p = document.getElementById('pattern').value;
-  var t = document.getElementById('timer').value;
-  
-  fetch('/set?brightness=' + b + '&pattern=' + p + '&timer=' + t)
-    .then(r => r.text())
-    .then(d => {
-      document.getElementById('status').innerText = d + ' 🎄';
-    })
-    .catch(e => {
-      document.getElementById('status').innerText = 'Error! ❌';
-    });
-}
-
-function playSong() {
-  var s = document.getElementById('song').value;
-  fetch('/play?song=' + s)
-    .then(r => r.text())
-    .then(d => {
-      document.getElementById('status').innerText = d + ' 🎵';
-    })
-    .catch(e => {
-      document.getElementById('status').innerText = 'Error! ❌';
-    });
-}
-
-function stopSong() {
-  fetch('/stop')
-    .then(r => r.text())
-    .then(d => {
-      document.getElementById('status').innerText = d + ' ⏹️';
-    })
-    .catch(e => {
-      document.getElementById('status').innerText = 'Error! ❌';
-    });
-}
-
-// Initialize snowflakes when page loads
-window.onload = createSnowflakes;
-</script>
-</body>
-</html>
-)rawliteral";
+const uint32_t batteryCheckInterval = 10000;
+uint32_t batteryGaps = 0;  // battery bursts that blanked the LEDs
+const uint32_t sensorOutputInterval = 10000;
+
+// Scheduler
+const uint32_t HEARTBEAT_INTERVAL = 1000;
+const uint32_t BUTTON_ACTIVE_POLL = 10;      // while a button is held or bouncing
+const uint32_t BUTTON_IDLE_POLL = 20;        // when buttons can't wake the CPU themselves
+const uint32_t WIFI_POLL_INTERVAL = 2;
+const uint32_t MODE_INDICATOR_FRAME = 20;
+uint32_t nextHeartbeat = 0;
+bool buttonsSettled = true;
+uint32_t lightSleepMs = 0;
+uint32_t idleDelayMs = 0;
 
 // Function prototypes
 void markSettingsChanged();
 void saveToMemory();
+void commitSettings();
 void loadSettings();
+void measureBattery();
 void checkPowerSource();
+void applyBatteryLevel();
+void applyBrightness();
+uint32_t patternInterval();
 void startWiFiAP();
 void stopWiFiAP();
-void handleRoot();
-void handleNotFound();
+void applyPortalCommand(const PortalCommand& command);
 uint64_t getTotalUptimeSeconds();
 uint32_t getElapsedCycleSeconds();
 bool isInOnPhase();
@@ -581,7 +196,50 @@ void startSong();
 void stopSong();
 void updateSong();
 void turnOffAllLEDs();
+void markFrameDirty();
+void fillLeds(const CRGB& color);
+void showFrame();
+uint8_t budgetBrightness();
 void checkWiFiTimeout();
+uint32_t heartbeatTask(uint32_t now);
+uint32_t buttonTask(uint32_t now);
+uint32_t wifiTask(uint32_t now);
+uint32_t songTask(uint32_t now);
+uint32_t patternTask(uint32_t now);
+uint32_t previewTask(uint32_t now);
+uint32_t batteryTask(uint32_t now);
+uint32_t sensorTask(uint32_t now);
+uint32_t saveTask(uint32_t now);
+bool canLightSleep();
+bool canDeepSleep(uint32_t now);
+void enterDeepSleep();
+void idleUntil(uint32_t deadline);
+
+// Task table, in the order tasks run within one pass
+enum TaskId {
+  TASK_HEARTBEAT,
+  TASK_BUTTONS,
+  TASK_WIFI,
+  TASK_SONG,
+  TASK_PATTERNS,
+  TASK_PREVIEW,
+  TASK_BATTERY,
+  TASK_SENSORS,
+  TASK_SAVE,
+  NUM_TASKS
+};
+
+Task tasks[NUM_TASKS] = {
+  {"heartbeat", heartbeatTask, 0},
+  {"buttons", buttonTask, 0},
+  {"wifi", wifiTask, 0},
+  {"song", songTask, 0},
+  {"patterns", patternTask, 0},
+  {"preview", previewTask, 0},
+  {"battery", batteryTask, 0},
+  {"sensors", sensorTask, 0},
+  {"save", saveTask, 0}
+};
 
 void WiFiStationConnected(WiFiEvent_t event, WiFiEventInfo_t info) {
   Serial.println("Client connected to AP!");
@@ -594,7 +252,7 @@ void WiFiStationDisconnected(WiFiEvent_t event, WiFiEventInfo_t info) {
 
 void checkWiFiTimeout() {
   if (wifiAPEnabled && wifiTimeoutEnabled) {
-    unsigned long currentTime = millis();
+    uint32_t currentTime = millis();
     
     // Check if WiFi has been active for more than 5 minutes
     if (currentTime - wifiAPStartTime >= WIFI_TIMEOUT) {
@@ -612,84 +270,63 @@ void checkWiFiTimeout() {
   }
 }
 
-void handleRoot() {
-  String html = String(FPSTR(htmlPage1)) + String(FPSTR(htmlPage2));
-  server.send(200, "text/html", html);
-}
-
-void handleSet() {
-  if (server.hasArg("brightness")) {
-    int brightness = server.arg("brightness").toInt();
-    if (brightness >= 10 && brightness <= 255) {
-      currentBrightness = brightness;
-      FastLED.setBrightness(currentBrightness);
+// Applies a command posted by a portal handler
+void applyPortalCommand(const PortalCommand& command) {
+  switch (command.type) {
+    case PORTAL_SET_BRIGHTNESS:
+      currentBrightness = command.value;
+      applyBrightness();
       Serial.print("Brightness set to: ");
-      Serial.println(brightness);
-    }
-  }
-  
-  if (server.hasArg("pattern")) {
-    int pattern = server.arg("pattern").toInt();
-    if (pattern >= 0 && pattern <= 13) {
-      if (pattern <= 1) {
+      Serial.println(command.value);
+      markSettingsChanged();
+      break;
+    
+    case PORTAL_SET_PATTERN:
+      if (command.value <= 1) {
         currentMode = STATIC_COLOR;
-        currentColorIndex = pattern;
+        currentColorIndex = command.value;
       } else {
-        currentMode = (DisplayMode)(pattern - 1);
+        currentMode = (DisplayMode)(command.value - 1);
       }
       updateDisplay();
       Serial.print("Pattern set to: ");
-      Serial.println(pattern);
-    }
-  }
-  
-  if (server.hasArg("timer")) {
-    int timer = server.arg("timer").toInt();
-    if (timer == 0 && timerEnabled) {
-      deactivateTimer();
-    } else if (timer == 1 && !timerEnabled) {
-      activateTimer();
-    }
-  }
-  
-  markSettingsChanged();
-  server.send(200, "text/plain", "Settings applied!");
-}
-
-void handlePlay() {
-  if (server.hasArg("song")) {
-    int songIndex = server.arg("song").toInt();
-    if (songIndex >= 0 && songIndex < NUM_CHRISTMAS_SONGS) {
-      currentSong = (ChristmasSong)songIndex;
+      Serial.println(command.value);
+      markSettingsChanged();
+      break;
+    
+    case PORTAL_SET_TIMER:
+      if (command.value == 0 && timerEnabled) {
+        deactivateTimer();
+      } else if (command.value == 1 && !timerEnabled) {
+        activateTimer();
+      }
+      markSettingsChanged();
+      break;
+    
+    case PORTAL_PLAY_SONG:
+      currentSong = (ChristmasSong)command.value;
       startSong();
-      server.send(200, "text/plain", "Playing: " + String(songNames[songIndex]));
       Serial.print("Playing song: ");
-      Serial.println(songNames[songIndex]);
-      return;
-    }
-  }
-  server.send(400, "text/plain", "Invalid song");
-}
-
-void handleStop() {
-  if (songState == PLAYING_SONG) {
-    stopSong();
-    server.send(200, "text/plain", "Song stopped");
-    Serial.println("Song stopped via web");
-  } else {
-    server.send(200, "text/plain", "No song playing");
+      Serial.println(songNames[command.value]);
+      break;
+    
+    case PORTAL_STOP_SONG:
+      if (songState == PLAYING_SONG) {
+        stopSong();
+        Serial.println("Song stopped via web");
+      }
+      break;
   }
 }
 
-void handleNotFound() {
-  // Redirect all requests to root for captive portal
-  server.sendHeader("Location", "http://192.168.4.1", true);
-  server.send(302, "text/plain", "");
-}
-
 void startWiFiAP() {
+  if (!ladderStep().wifi) {
+    Serial.println("Battery too low for WiFi");
+    return;
+  }
   if (!wifiAPEnabled) {
     Serial.println("Starting WiFi AP...");
+    powerHold(POWER_LOCK_WIFI, true);
     
     // Register WiFi event handlers
     WiFi.onEvent(WiFiStationConnected, ARDUINO_EVENT_WIFI_AP_STACONNECTED);
@@ -709,22 +346,13 @@ void startWiFiAP() {
     // Start DNS server for captive portal
     dnsServer.start(DNS_PORT, "*", WiFi.softAPIP());
     
-    // Setup web server with control endpoints
-    server.on("/", handleRoot);
-    server.on("/set", handleSet);           // Settings control
-    server.on("/play", handlePlay);         // Play song
-    server.on("/stop", handleStop);         // Stop song
-    server.on("/generate_204", handleRoot);  // Android captive portal check
-    server.on("/fwlink", handleRoot);         // Microsoft captive portal check
-    server.on("/hotspot-detect.html", handleRoot); // iOS/macOS captive portal
-    server.on("/canonical.html", handleRoot); // Ubuntu
-    server.on("/success.txt", handleRoot);    // Firefox
-    server.on("/connecttest.txt", handleRoot); // Windows
-    server.onNotFound(handleNotFound);
-    server.begin();
+    // Control endpoints, served on the AsyncTCP task
+    portalBegin();
     
     wifiAPEnabled = true;
     wifiAPStartTime = millis();
+    wakeTask(tasks[TASK_WIFI]);
+    wakeTask(tasks[TASK_PREVIEW]);
     
     Serial.println("WiFi AP Started!");
     Serial.println("Connect to: Kerstgroet_Joel");
@@ -736,11 +364,12 @@ void startWiFiAP() {
 
 void stopWiFiAP() {
   if (wifiAPEnabled) {
-    server.stop();
+    portalEnd();
     dnsServer.stop();
     WiFi.softAPdisconnect(true);
     WiFi.mode(WIFI_OFF);
     wifiAPEnabled = false;
+    powerHold(POWER_LOCK_WIFI, false);
     Serial.println("WiFi AP Stopped");
   }
 }
@@ -750,49 +379,50 @@ void markSettingsChanged() {
 }
 
 void saveToMemory() {
-  unsigned long currentMillis = millis();
+  uint32_t currentMillis = millis();
   
   if (currentMillis < lastSaveTime) {
     lastSaveTime = currentMillis;
   }
   
   if (currentMillis - lastSaveTime >= saveInterval && settingsChanged) {
-    preferences.begin("xmas-pcb", false);
-    
-    preferences.putUChar("displayMode", (uint8_t)currentMode);
-    preferences.putUChar("colorIndex", currentColorIndex);
-    preferences.putUChar("songIndex", (uint8_t)currentSong);
-    preferences.putULong("uptimeLow", totalUptimeLow);
-    preferences.putULong("uptimeHigh", totalUptimeHigh);
-    
-    preferences.putBool("timerEnabled", timerEnabled);
-    preferences.putULong("cycleStartLow", cycleStartUptimeLow);
-    preferences.putULong("cycleStartHigh", cycleStartUptimeHigh);
-    
-    preferences.end();
-    
-    lastSaveTime = currentMillis;
-    settingsChanged = false;
-    Serial.println("Settings saved");
+    commitSettings();
   }
 }
 
-void loadSettings() {
-  preferences.begin("xmas-pcb", true);
+// Writes pending changes now, outside the saveInterval batching
+void commitSettings() {
+  StoredSettings settings;
+  settings.displayMode = (uint8_t)currentMode;
+  settings.colorIndex = currentColorIndex;
+  settings.songIndex = (uint8_t)currentSong;
+  settings.timerEnabled = timerEnabled;
+  settings.cycleStart = ((uint64_t)cycleStartUptimeHigh << 32) | cycleStartUptimeLow;
+  settings.consumedMah = fuelConsumedMah() / FUEL_SAVE_STEP_MAH * FUEL_SAVE_STEP_MAH;
+  savedConsumedMah = settings.consumedMah;
   
-  currentMode = (DisplayMode)preferences.getUChar("displayMode", STATIC_COLOR);
-  currentColorIndex = preferences.getUChar("colorIndex", 0);
-  currentSong = (ChristmasSong)preferences.getUChar("songIndex", SANTA_CLAUS_IS_COMIN);
-  totalUptimeLow = preferences.getULong("uptimeLow", 0);
-  totalUptimeHigh = preferences.getULong("uptimeHigh", 0);
-  
-  timerEnabled = preferences.getBool("timerEnabled", false);
-  cycleStartUptimeLow = preferences.getULong("cycleStartLow", 0);
-  cycleStartUptimeHigh = preferences.getULong("cycleStartHigh", 0);
-  
-  preferences.end();
-  
-  lastMillisCheck = millis();
+  lastSaveTime = millis();
+  settingsChanged = false;
+  if (storeCommit(settings)) Serial.println("Settings saved");
+}
+
+void loadSettings() {
+  StoredSettings settings = {STATIC_COLOR, 0, SANTA_CLAUS_IS_COMIN, false, 0, 0};
+  uint64_t uptime = 0;
+  storeBegin(settings, uptime);
+  
+  currentMode = (DisplayMode)settings.displayMode;
+  if (currentMode >= NUM_DISPLAY_MODES) currentMode = STATIC_COLOR;
+  currentColorIndex = settings.colorIndex;
+  currentSong = (ChristmasSong)settings.songIndex;
+  totalUptimeLow = (uint32_t)uptime;
+  totalUptimeHigh = (uint32_t)(uptime >> 32);
+  
+  timerEnabled = settings.timerEnabled;
+  cycleStartUptimeLow = (uint32_t)settings.cycleStart;
+  cycleStartUptimeHigh = (uint32_t)(settings.cycleStart >> 32);
+  savedConsumedMah = settings.consumedMah;
+  fuelBegin(savedConsumedMah);
   
   Serial.println("Settings loaded");
   Serial.print("Timer Mode: ");
@@ -810,43 +440,100 @@ void loadSettings() {
   }
 }
 
+// Takes a battery burst with the strip dark: on batteries a lit strip is
+// blanked for it (about a millisecond, too short to see) and shown again
+void measureBattery() {
+  // The buzzer's current would ripple the reading; the next check measures
+  if (songState == PLAYING_SONG) return;
+  
+  // On USB the reading only has to stay below BATT_NO_DETECT_MV; a switch to
+  // batteries is a step that restarts the filter
+  if (currentPowerSource != POWER_AAA) {
+    batterySample();
+    return;
+  }
+  
+  // leds[] holds a frame showFrame() hasn't sent (and dimmed) yet: it is not
+  // what the strip shows, so leave the burst to the next check
+  if (frameVersion != shownFrameVersion) return;
+  
+  bool dark = true;
+  for (int i = 0; i < NUM_LEDS; i++) {
+    if (leds[i].r || leds[i].g || leds[i].b) dark = false;
+  }
+  if (dark || FastLED.getBrightness() == 0) {
+    batterySample();
+    return;
+  }
+  
+  powerHold(POWER_LOCK_SHOW, true);
+  FastLED.show(0);
+  delayMicroseconds(BATT_SETTLE_US);
+  batterySample();
+  FastLED.show(shownBrightness);
+  powerHold(POWER_LOCK_SHOW, false);
+  batteryGaps++;
+}
+
 void checkPowerSource() {
-  int reading = analogRead(BATT_SENSE);
-  float voltage = (reading / 4095.0) * 3.3;
+  uint16_t millivolts = batteryMillivolts();
+  PowerSource previousSource = currentPowerSource;
   
   // Print battery voltage to terminal
   Serial.print("Battery voltage: ");
-  Serial.print(voltage);
-  Serial.print("V - ");
+  Serial.print(millivolts);
+  Serial.print(" mV - ");
   
-  if (voltage < BATT_NO_DETECT) {
+  if (millivolts < BATT_NO_DETECT_MV) {
     currentPowerSource = POWER_USB;
-    currentBrightness = BRIGHTNESS_USB;
     Serial.println("USB Power");
-  } else if (voltage >= BATT_AAA_MIN && voltage <= BATT_AAA_MAX) {
+  } else if (millivolts >= BATT_AAA_MIN_MV && millivolts <= BATT_AAA_MAX_MV) {
     currentPowerSource = POWER_AAA;
-    currentBrightness = BRIGHTNESS_BATTERY;
-    
-    // Calculate battery percentage (rough estimate for AAA)
-    int batteryPercent = map((int)(voltage * 100), (int)(BATT_AAA_MIN * 100), (int)(BATT_AAA_MAX * 100), 0, 100);
-    batteryPercent = constrain(batteryPercent, 0, 100);
     
+    // By the fuel gauge, as of the last check
     Serial.print("Battery Power (");
-    Serial.print(batteryPercent);
+    Serial.print(fuelPercent());
     Serial.println("%)");
-    
-    // Auto-disable WiFi if battery voltage is getting low
-    if (voltage < (BATT_AAA_MIN + 0.2) && wifiAPEnabled) { // 1.7V threshold
-      Serial.println("Battery voltage low - disabling WiFi to conserve power");
-      stopWiFiAP();
-    }
   } else {
     currentPowerSource = POWER_AAA;
-    currentBrightness = BRIGHTNESS_BATTERY;
     Serial.println("Battery Power (unknown level)");
   }
   
-  FastLED.setBrightness(currentBrightness);
+  // The source's default brightness replaces the user's only when the source
+  // changes; the ladder and the power budget limit it from there
+  if (currentPowerSource != previousSource) {
+    currentBrightness = currentPowerSource == POWER_USB ? BRIGHTNESS_USB : BRIGHTNESS_BATTERY;
+  }
+  
+  BatteryLevel before = ladderLevel();
+  if (ladderUpdate(currentPowerSource == POWER_AAA, millivolts) != before) applyBatteryLevel();
+  applyBrightness();
+  powerHold(POWER_LOCK_USB, currentPowerSource == POWER_USB);
+  
+  fuelUpdate(currentPowerSource == POWER_AAA, wifiAPEnabled, songState == PLAYING_SONG, millivolts);
+  if (fuelConsumedMah() / FUEL_SAVE_STEP_MAH != savedConsumedMah / FUEL_SAVE_STEP_MAH) markSettingsChanged();
+}
+
+// Gives up what the low-battery ladder's step doesn't allow (battery_ladder.h)
+void applyBatteryLevel() {
+  const BatteryStep& step = ladderStep();
+  if (!step.wifi && wifiAPEnabled) {
+    Serial.println("Battery low - disabling WiFi to conserve power");
+    stopWiFiAP();
+  }
+  if (step.songDuty == 0 && songState == PLAYING_SONG) {
+    Serial.println("Battery low - song stopped");
+    stopSong();
+  }
+  audioSetDuty(step.songDuty);
+  // Pattern steps may now be further apart
+  wakeTask(tasks[TASK_PATTERNS]);
+}
+
+// The set brightness, capped by the low-battery ladder
+void applyBrightness() {
+  uint8_t cap = ladderStep().maxBrightness;
+  FastLED.setBrightness(currentBrightness < cap ? currentBrightness : cap);
 }
 
 uint64_t getTotalUptimeSeconds() {
@@ -919,6 +606,7 @@ void showModeIndicator() {
   
   showingModeIndicator = true;
   modeIndicatorStartTime = millis();
+  wakeTask(tasks[TASK_PATTERNS]);
   
   Serial.print("Mode indicator: Timer ");
   Serial.println(timerEnabled ? "ENABLED" : "DISABLED");
@@ -927,13 +615,14 @@ void showModeIndicator() {
 void updateModeIndicator() {
   if (!showingModeIndicator) return;
   
-  unsigned long elapsed = millis() - modeIndicatorStartTime;
+  uint32_t elapsed = millis() - modeIndicatorStartTime;
   
   if (elapsed >= MODE_INDICATOR_DURATION) {
     showingModeIndicator = false;
     for(int i = 0; i < NUM_LEDS; i++) {
       leds[i] = savedLedsBeforeIndicator[i];
     }
+    markFrameDirty();
     return;
   }
   
@@ -952,6 +641,7 @@ void updateModeIndicator() {
     leds[TOP_LED] = CRGB::Red;
     leds[TOP_LED].nscale8(brightness);
   }
+  markFrameDirty();
 }
 
 bool shouldShowLEDs() {
@@ -1001,7 +691,7 @@ void checkButtons() {
           button1PressStartTime = millis();
           button1LongPressDetected = false;
         } else {
-          unsigned long pressDuration = millis() - button1PressStartTime;
+          uint32_t pressDuration = millis() - button1PressStartTime;
           
           if (!button1LongPressDetected && pressDuration < longPressTime) {
             handleButton1Press();
@@ -1037,11 +727,11 @@ void handleBothButtonsPress() {
   
   // Visual feedback
   for(int i = 0; i < 3; i++) {
-    fill_solid(leds, NUM_LEDS, CRGB::Yellow1);
-    FastLED.show();
+    fillLeds(CRGB::Yellow1);
+    showFrame();
     delay(200);
     turnOffAllLEDs();
-    FastLED.show();
+    showFrame();
     delay(200);
   }
   
@@ -1065,27 +755,13 @@ void handleButton1Press() {
     }
   } else {
     currentMode = (DisplayMode)((int)currentMode + 1);
-    if (currentMode > OFF_MODE) {
+    if (currentMode >= NUM_DISPLAY_MODES) {
       currentMode = STATIC_COLOR;
       currentColorIndex = 0;
       Serial.println("Mode: STATIC RED");
     } else {
       Serial.print("Mode: ");
-      switch(currentMode) {
-        case RANDOM_SCATTER: Serial.println("SCATTER"); break;
-        case RAINBOW_MODE: Serial.println("RAINBOW"); break;
-        case SNAKE_MODE: Serial.println("SNAKE"); break;
-        case RANDOM_BLINK: Serial.println("BLINK"); break;
-        case CHASE_MODE: Serial.println("CHASE"); break;
-        case WAVE_MODE: Serial.println("WAVE"); break;
-        case FADE_RANDOM: Serial.println("FADE"); break;
-        case SPARKLE_MODE: Serial.println("SPARKLE"); break;
-        case FIREWORK_MODE: Serial.println("FIREWORK"); break;
-        case METEOR_MODE: Serial.println("METEOR"); break;
-        case CANDY_CANE_MODE: Serial.println("CANDY"); break;
-        case OFF_MODE: Serial.println("OFF"); break;
-        default: break;
-      }
+      Serial.println(patterns[currentMode].name);
     }
   }
   updateDisplay();
@@ -1119,196 +795,57 @@ void handleButton2Press() {
   }
 }
 
-void updateRandomScatter() {
-  for(int i = 0; i < NUM_LEDS; i++) {
-    if(random8(4) == 0) {
-      leds[i] = random8(2) == 0 ? CRGB::Red : CRGB::Green;
-    }
-  }
-}
-
-void updateFadeRandom() {
-  if (needNewFadeTarget) {
-    for(int i = 0; i < NUM_LEDS; i++) {
-      currentFadeColors[i] = leds[i];
-      targetFadeColors[i] = random8(2) == 0 ? CRGB::Red : CRGB::Green;
-    }
-    needNewFadeTarget = false;
-    fadeProgress = 0;
-  }
-  
-  fadeProgress += 4;
-  for(int i = 0; i < NUM_LEDS; i++) {
-    leds[i] = blend(currentFadeColors[i], targetFadeColors[i], fadeProgress);
-  }
-  
-  if(fadeProgress >= 255) {
-    needNewFadeTarget = true;
-  }
-}
-
-void updateSparklePattern() {
-  if(random8(3) == 0) {
-    uint8_t pos = random8(NUM_LEDS);
-    if(sparkleBrightness[pos] == 0) {
-      sparklePositions[pos] = pos;
-      sparkleBrightness[pos] = 255;
-      sparkleColors[pos] = random8(2);
-    }
-  }
-  
-  for(int i = 0; i < NUM_LEDS; i++) {
-    if(sparkleBrightness[i] > 0) {
-      leds[i] = sparkleColors[i] == 0 ? CRGB::Red : CRGB::Green;
-      leds[i].nscale8(sparkleBrightness[i]);
-      sparkleBrightness[i] = (sparkleBrightness[i] * 3) >> 2;
-    } else {
-      leds[i] = CRGB::Black;
-    }
-  }
+void turnOffAllLEDs() {
+  fillLeds(CRGB::Black);
 }
 
-void updateFireworkPattern() {
-  turnOffAllLEDs();
-  
-  if(currentFirework.position == -1) {
-    currentFirework.position = 0;
-    currentFirework.phase = 0;
-    currentFirework.brightness = 255;
-    currentFirework.isRed = random8(2) == 0;
-  }
-  
-  switch(currentFirework.phase) {
-    case 0:
-      leds[currentFirework.position] = currentFirework.isRed ? CRGB::Red : CRGB::Green;
-      leds[currentFirework.position].nscale8(currentFirework.brightness);
-      currentFirework.position++;
-      if(currentFirework.position >= NUM_LEDS/2) {
-        currentFirework.phase = 1;
-      }
-      break;
-      
-    case 1:
-      for(int i = 0; i < NUM_LEDS; i++) {
-        if(random8(2) == 0) {
-          leds[i] = currentFirework.isRed ? CRGB::Red : CRGB::Green;
-          leds[i].nscale8(currentFirework.brightness);
-        }
-      }
-      currentFirework.brightness = (currentFirework.brightness * 7) >> 3;
-      if(currentFirework.brightness < 40) {
-        currentFirework.phase = 2;
-      }
-      break;
-      
-    case 2:
-      currentFirework.position = -1;
-      break;
-  }
+void markFrameDirty() {
+  frameVersion++;
 }
 
-void updateMeteorPattern() {
+// Solid fills are what the static modes and the timer OFF phase repeat for
+// hours; only count them as a new frame when a pixel actually changes
+void fillLeds(const CRGB& color) {
   for(int i = 0; i < NUM_LEDS; i++) {
-    leds[i].nscale8(192);
-  }
-  
-  if(meteorPos == -1) {
-    meteorPos = NUM_LEDS;
-    meteorIsRed = !meteorIsRed;
-    for(int i = 0; i < 3; i++) {
-      meteorTail[i] = 255 - (i * 64);
-    }
-  }
-  
-  meteorPos--;
-  
-  for(int i = 0; i < 3; i++) {
-    int pos = meteorPos + i;
-    if(pos >= 0 && pos < NUM_LEDS) {
-      leds[pos] = meteorIsRed ? CRGB::Red : CRGB::Green;
-      leds[pos].nscale8(meteorTail[i]);
+    if (!(leds[i] == color)) {
+      fill_solid(leds, NUM_LEDS, color);
+      markFrameDirty();
+      return;
     }
   }
-  
-  if(meteorPos < -3) {
-    meteorPos = -1;
-  }
 }
 
-void updateCandyCanePattern() {
-  candyOffset = (candyOffset + 1) % (NUM_LEDS * 2);
-  for(int i = 0; i < NUM_LEDS; i++) {
-    bool isRed = ((i + candyOffset/2) / stripeWidth) % 2 == 0;
-    leds[i] = isRed ? CRGB::Red : CRGB::Green;
-  }
-}
-
-void updateRainbowPattern() {
-  static uint8_t colorStep = 0;
-  colorStep++;
-  for (int i = 0; i < NUM_LEDS; i++) {
-    leds[i] = (((colorStep + i) % 2) == 0) ? CRGB::Red : CRGB::Green;
+void showFrame() {
+  uint8_t brightness = budgetBrightness();
+  if (frameVersion == shownFrameVersion && brightness == shownBrightness) {
+    framesSkipped++;
+    return;
   }
-}
-
-void updateSnakePattern() {
-  turnOffAllLEDs();
-  snakeHeadPos = (snakeHeadPos + 1) % NUM_LEDS;
-  
-  static uint8_t snakeColorIndex = 0;
-  if (snakeHeadPos == 0) snakeColorIndex = (snakeColorIndex + 1) % 2;
-  CRGB snakeColor = (snakeColorIndex == 0) ? CRGB::Red : CRGB::Green;
   
-  for (int i = 0; i < snakeLength; i++) {
-    int pos = (snakeHeadPos - i + NUM_LEDS) % NUM_LEDS;
-    int brightness = 255 - (i * 255 / snakeLength);
-    leds[pos] = snakeColor;
-    leds[pos].nscale8(brightness);
-  }
-}
-
-void updateRandomBlinkPattern(unsigned long currentTime) {
-  if (currentTime - lastRandomUpdate >= 600) {
-    lastRandomUpdate = currentTime;
-    
-    for (int i = 0; i < 3; i++) {
-      if (randomLEDs[i] < NUM_LEDS) {
-        leds[randomLEDs[i]] = CRGB::Black;
-      }
-    }
-    
-    for (int i = 0; i < 3; i++) {
-      randomLEDs[i] = random8(NUM_LEDS);
-      leds[randomLEDs[i]] = random8(2) == 0 ? CRGB::Red : CRGB::Green;
-    }
-  }
-}
-
-void updateChasePattern() {
-  turnOffAllLEDs();
-  static uint8_t chaseColorIndex = 0;
-  CRGB chaseColor = (chaseColorIndex == 0) ? CRGB::Red : CRGB::Green;
-  leds[chasePos] = chaseColor;
-  chasePos = (chasePos + 1) % NUM_LEDS;
-  if (chasePos == 0) chaseColorIndex = (chaseColorIndex + 1) % 2;
+  powerHold(POWER_LOCK_SHOW, true);
+  FastLED.show(brightness);
+  powerHold(POWER_LOCK_SHOW, false);
+  shownFrameVersion = frameVersion;
+  shownBrightness = brightness;
+  framesShown++;
+  if (brightness < FastLED.getBrightness()) framesLimited++;
+  fuelFrame(leds, NUM_LEDS, shownBrightness);
 }
 
-void updateWavePattern() {
-  waveOffset += 10;
-  for (int i = 0; i < NUM_LEDS; i++) {
-    uint8_t sinBrightness = sin8(waveOffset + (i * 255 / NUM_LEDS));
-    CRGB waveColor = (i % 2 == 0) ? CRGB::Red : CRGB::Green;
-    leds[i] = waveColor;
-    leds[i].nscale8(sinBrightness);
-  }
+// The set brightness, dimmed for this frame if the power budget requires it
+uint8_t budgetBrightness() {
+  uint32_t budget = (currentPowerSource == POWER_USB ? POWER_BUDGET_USB_MA : POWER_BUDGET_BATTERY_MA) * 1000UL;
+  uint32_t others = fuelPeakMicroamps(wifiAPEnabled, songState == PLAYING_SONG);
+  return fuelLimitBrightness(leds, NUM_LEDS, FastLED.getBrightness(), others, budget);
 }
 
-void turnOffAllLEDs() {
-  fill_solid(leds, NUM_LEDS, CRGB::Black);
+// Time between pattern steps, stretched by the low-battery ladder
+uint32_t patternInterval() {
+  return patterns[currentMode].interval * ladderStep().frameSlowdown;
 }
 
 void updatePatterns() {
-  unsigned long currentTime = millis();
+  uint32_t currentTime = millis();
   
   if (showingModeIndicator) {
     updateModeIndicator();
@@ -1320,122 +857,63 @@ void updatePatterns() {
     return;
   }
   
-  switch (currentMode) {
-    case RANDOM_SCATTER: patternUpdateInterval = SCATTER_SPEED; break;
-    case SPARKLE_MODE: patternUpdateInterval = SPARKLE_SPEED; break;
-    case FIREWORK_MODE: patternUpdateInterval = FIREWORK_SPEED; break;
-    case METEOR_MODE: patternUpdateInterval = METEOR_SPEED; break;
-    case CANDY_CANE_MODE: patternUpdateInterval = CANDY_SPEED; break;
-    case RAINBOW_MODE: patternUpdateInterval = RAINBOW_SPEED; break;
-    case SNAKE_MODE: patternUpdateInterval = SNAKE_SPEED; break;
-    case CHASE_MODE: patternUpdateInterval = CHASE_SPEED; break;
-    case WAVE_MODE: patternUpdateInterval = WAVE_SPEED; break;
-    case FADE_RANDOM: patternUpdateInterval = FADE_SPEED; break;
-    default: patternUpdateInterval = 50; break;
-  }
-  
-  if (currentTime - lastPatternUpdate >= patternUpdateInterval) {
+  if (currentTime - lastPatternUpdate >= patternInterval()) {
     lastPatternUpdate = currentTime;
-    
-    switch (currentMode) {
-      case STATIC_COLOR:
-        fill_solid(leds, NUM_LEDS, colorOptions[currentColorIndex]);
-        break;
-      case RANDOM_SCATTER: updateRandomScatter(); break;
-      case RAINBOW_MODE: updateRainbowPattern(); break;
-      case SNAKE_MODE: updateSnakePattern(); break;
-      case RANDOM_BLINK: updateRandomBlinkPattern(currentTime); break;
-      case CHASE_MODE: updateChasePattern(); break;
-      case WAVE_MODE: updateWavePattern(); break;
-      case FADE_RANDOM: updateFadeRandom(); break;
-      case SPARKLE_MODE: updateSparklePattern(); break;
-      case FIREWORK_MODE: updateFireworkPattern(); break;
-      case METEOR_MODE: updateMeteorPattern(); break;
-      case CANDY_CANE_MODE: updateCandyCanePattern(); break;
-      case OFF_MODE: turnOffAllLEDs(); break;
-    }
+    if (stepPattern(currentMode, leds)) markFrameDirty();
   }
 }
 
 void updateDisplay() {
+  wakeTask(tasks[TASK_PATTERNS]);
+  
   if (!shouldShowLEDs()) {
     turnOffAllLEDs();
     return;
   }
   
-  turnOffAllLEDs();
-  
   uint32_t seed = analogRead(LDR_PIN);
   randomSeed(seed);
   
-  switch (currentMode) {
-    case STATIC_COLOR:
-      fill_solid(leds, NUM_LEDS, colorOptions[currentColorIndex]);
-      break;
-    case RANDOM_SCATTER:
-      for(int i = 0; i < NUM_LEDS; i++) {
-        leds[i] = random(2) == 0 ? CRGB::Red : CRGB::Green;
-      }
-      break;
-    case SPARKLE_MODE:
-      memset(sparkleBrightness, 0, sizeof(sparkleBrightness));
-      break;
-    case FIREWORK_MODE:
-      currentFirework.position = -1;
-      break;
-    case METEOR_MODE:
-      meteorPos = -1;
-      break;
-    case FADE_RANDOM:
-      needNewFadeTarget = true;
-      break;
-    default:
-      break;
-  }
+  beginPattern(currentMode, leds, colorOptions[currentColorIndex]);
+  markFrameDirty();
 }
 
 void startSong() {
+  if (ladderStep().songDuty == 0) {
+    Serial.println("Battery too low for songs");
+    return;
+  }
   songState = PLAYING_SONG;
+  powerHold(POWER_LOCK_SONG, true);
   currentSongData = getSongData(currentSong);
+  audioStart(currentSongData);
+  wakeTask(tasks[TASK_SONG]);
   Serial.print("Playing: ");
   Serial.println(songNames[currentSong]);
 }
 
 void stopSong() {
   songState = IDLE;
-  noTone(BUZZER);
+  audioStop();
+  powerHold(POWER_LOCK_SONG, false);
   updateDisplay();
 }
 
+// Notes are played by the audio engine's timer; loop() only keeps its queue topped up
 void updateSong() {
   if (songState == PLAYING_SONG) {
-    unsigned long currentTime = millis();
-    
-    if (currentTime - lastNoteTime >= currentNoteDuration) {
-      if (currentNote >= currentSongData.size * 2) {
-        songState = IDLE;
-        noTone(BUZZER);
-        currentNote = 0;
-        
-        currentSong = (ChristmasSong)((int)currentSong + 1);
-        if (currentSong >= NUM_CHRISTMAS_SONGS) {
-          currentSong = SANTA_CLAUS_IS_COMIN;
-        }
-        return;
-      }
+    if (audioFinished()) {
+      songState = IDLE;
+      powerHold(POWER_LOCK_SONG, false);
       
-      uint16_t wholeNote = (60000 * 4) / currentSongData.baseTempo;
-      int8_t noteType = pgm_read_word(&currentSongData.melody[currentNote + 1]);
-      if (noteType > 0) {
-        currentNoteDuration = wholeNote / noteType;
-      } else {
-        currentNoteDuration = wholeNote / abs(noteType) * 1.5;
+      currentSong = (ChristmasSong)((int)currentSong + 1);
+      if (currentSong >= NUM_CHRISTMAS_SONGS) {
+        currentSong = SANTA_CLAUS_IS_COMIN;
       }
-      
-      tone(BUZZER, pgm_read_word(&currentSongData.melody[currentNote]), currentNoteDuration * 0.9);
-      lastNoteTime = currentTime;
-      currentNote += 2;
+      return;
     }
+    
+    audioFill();
   }
 }
 
@@ -1475,22 +953,82 @@ void outputSensorData() {
   Serial.print("Power: ");
   Serial.println(currentPowerSource == POWER_USB ? "USB" : "Battery");
   
+  const BatteryStats& battery = batteryStats();
+  Serial.print("Battery sense: ");
+  Serial.print(batteryMillivolts());
+  Serial.print(" mV filtered, last burst ");
+  Serial.print(battery.lastBurstMv);
+  Serial.print(" mV, ");
+  Serial.print(battery.bursts);
+  Serial.print(" bursts (");
+  Serial.print(batteryGaps);
+  Serial.print(" in an LED gap), ");
+  Serial.print(battery.resets);
+  Serial.println(" source steps");
+  ladderPrintStats();
+  fuelPrintStats(TIMER_ON_DURATION, TIMER_CYCLE_DURATION);
+  
   Serial.print("WiFi AP: ");
   Serial.println(wifiAPEnabled ? "Active" : "Inactive");
+  portalPrintStats();
+
+  // A largest block far below the free total means the heap is fragmenting
+  Serial.print("Heap: ");
+  Serial.print(ESP.getFreeHeap());
+  Serial.print(" B free, largest block ");
+  Serial.print(ESP.getMaxAllocHeap());
+  Serial.print(" B, lowest ");
+  Serial.print(ESP.getMinFreeHeap());
+  Serial.println(" B");
+  storePrintStats();
+  
+  Serial.print("Idle: ");
+  Serial.print(lightSleepMs / 1000);
+  Serial.print("s light sleep, ");
+  Serial.print(idleDelayMs / 1000);
+  Serial.println("s delay");
+  powerPrintStats();
+  
+  Serial.print("LED frames: ");
+  Serial.print(framesShown);
+  Serial.print(" shown, ");
+  Serial.print(framesSkipped);
+  Serial.print(" skipped (unchanged), ");
+  Serial.print(framesLimited);
+  Serial.println(" dimmed by the power budget");
+  
+  const AudioStats& audio = audioStats();
+  Serial.print("Audio: ");
+  Serial.print(audio.notesPlayed);
+  Serial.print(" notes, ");
+  Serial.print(audio.underruns);
+  Serial.print(" underruns, max lateness ");
+  Serial.print(audio.maxLatenessUs);
+  Serial.println("us");
   
   Serial.println("==============\n");
   Serial.flush();
 }
 
 void setup() {
+  esp_sleep_wakeup_cause_t wakeCause = esp_sleep_get_wakeup_cause();
+  bool deepSleepWake = wakeCause == ESP_SLEEP_WAKEUP_TIMER || wakeCause == ESP_SLEEP_WAKEUP_GPIO;
+  
   Serial.begin(115200);
-  delay(1000);
+  if (!deepSleepWake) delay(1000);
   
   Serial.println("\n\n=== Christmas PCB ===");
   Serial.println("=== 6h Timer System ==============");
   Serial.println("=== Hold both buttons for WiFi AP ===");
   
+  powerBegin();
+  
+  // Deep sleep held these low
+  gpio_hold_dis((gpio_num_t)RGB_PIN);
+  gpio_hold_dis((gpio_num_t)BUZZER);
+  
   pinMode(BUZZER, OUTPUT);
+  audioBegin(BUZZER);
   pinMode(BUTTON1, INPUT_PULLUP);
   pinMode(BUTTON2, INPUT_PULLUP);
   pinMode(BATT_SENSE, INPUT);
@@ -1506,14 +1044,29 @@ void setup() {
   // Disable WiFi by default
   WiFi.mode(WIFI_OFF);
   
+  batteryBegin(BATT_SENSE);
+  ladderBegin();
+  loadSettings();
   checkPowerSource();
   
   FastLED.addLeds<WS2812B, RGB_PIN, GRB>(leds, NUM_LEDS);
-  FastLED.setBrightness(currentBrightness);
+  applyBrightness();
   
-  loadSettings();
+  if (wakeCause == ESP_SLEEP_WAKEUP_GPIO) {
+    Serial.println("Woken from deep sleep by a button");
+    if (timerEnabled && !isInOnPhase()) {
+      manualOverride = true;
+      Serial.println("Manual override - LEDs ON (timer still active)");
+    }
+    // The press that woke the board does nothing else
+    button1State = lastButton1State = digitalRead(BUTTON1);
+    button2State = lastButton2State = digitalRead(BUTTON2);
+    button1LongPressDetected = button1State == LOW;
+  } else if (wakeCause == ESP_SLEEP_WAKEUP_TIMER) {
+    Serial.println("Woken from deep sleep by the timer");
+  }
   updateDisplay();
-  FastLED.show();
+  showFrame();
   
   Serial.println("\nReady!");
   Serial.println("Button 1 SHORT: Change pattern");
@@ -1521,52 +1074,216 @@ void setup() {
   Serial.println("Button 2: Play/Stop songs");
   Serial.println("Both buttons (1s): WiFi AP with message");
   printPowerStatus();
+  
+  // After deep sleep the uptime already counts the time asleep, so the next
+  // second is a whole one away
+  nextHeartbeat = millis() + (deepSleepWake ? HEARTBEAT_INTERVAL : 0);
+  // A timer wake-up may go straight back to sleep; otherwise someone is around
+  deepSleepAllowedAt = millis() + (wakeCause == ESP_SLEEP_WAKEUP_TIMER ? 0 : DEEP_SLEEP_DELAY);
+  startTasks(tasks, NUM_TASKS, millis());
+  tasks[TASK_HEARTBEAT].due = nextHeartbeat;
 }
 
-void loop() {
-  static unsigned long lastHeartbeat = 0;
-  unsigned long currentMillis = millis();
+uint32_t heartbeatTask(uint32_t now) {
+  totalUptimeLow++;
+  if (totalUptimeLow == 0) totalUptimeHigh++;
+  storeUptime(getTotalUptimeSeconds());
   
-  if (currentMillis - lastHeartbeat >= 1000) {
-    totalUptimeLow++;
-    if (totalUptimeLow == 0) totalUptimeHigh++;
-    
-    if (currentMillis < lastMillisCheck) {
-      markSettingsChanged();
-    }
-    lastMillisCheck = currentMillis;
-    
-    lastHeartbeat = currentMillis;
-    markSettingsChanged();
+  updateTimerState();
+  
+  // Keep to whole seconds so uptime doesn't drift with scheduling latency
+  nextHeartbeat += HEARTBEAT_INTERVAL;
+  if (timeUntil(nextHeartbeat, now) < -(int32_t)HEARTBEAT_INTERVAL) nextHeartbeat = now;
+  int32_t untilNext = timeUntil(nextHeartbeat, now);
+  return untilNext > 0 ? untilNext : 0;
+}
+
+uint32_t buttonTask(uint32_t now) {
+  checkButtons();
+  
+  buttonsSettled = lastButton1State == HIGH && lastButton2State == HIGH &&
+                   button1State == HIGH && button2State == HIGH &&
+                   !bothButtonsPressed && (now - lastDebounceTime) > debounceDelay;
+  if (!buttonsSettled) {
+    deepSleepAllowedAt = now + DEEP_SLEEP_DELAY;
+    return BUTTON_ACTIVE_POLL;
   }
   
-  // Check WiFi timeout
-  if (wifiAPEnabled) {
-    checkWiFiTimeout();
+  // Released buttons wake the CPU through GPIO; idleUntil() polls them otherwise
+  return TASK_IDLE;
+}
+
+uint32_t wifiTask(uint32_t now) {
+  if (!wifiAPEnabled) return TASK_IDLE;
+  
+  checkWiFiTimeout();
+  if (!wifiAPEnabled) return TASK_IDLE;
+  
+  dnsServer.processNextRequest();
+  
+  PortalCommand command;
+  while (portalNextCommand(command)) {
+    applyPortalCommand(command);
   }
   
-  updateTimerState();
-  checkButtons();
+  PortalState state;
+  state.brightness = currentBrightness;
+  state.pattern = currentMode != STATIC_COLOR ? currentMode + 1 : (currentColorIndex > 1 ? 1 : currentColorIndex);
+  state.timer = timerEnabled;
+  state.song = songState == PLAYING_SONG ? currentSong + 1 : 0;
+  state.timerOnPhase = isInOnPhase();
+  state.battery = currentPowerSource != POWER_USB;
+  state.minutesLeft = 0;
+  if (timerEnabled) {
+    uint32_t elapsed = getElapsedCycleSeconds();
+    uint32_t phaseEnd = elapsed < TIMER_ON_DURATION ? TIMER_ON_DURATION : TIMER_CYCLE_DURATION;
+    state.minutesLeft = (phaseEnd - elapsed + 59) / 60;
+  }
+  portalUpdate(state);
+  return WIFI_POLL_INTERVAL;
+}
+
+uint32_t songTask(uint32_t now) {
   updateSong();
+  if (songState != PLAYING_SONG) return TASK_IDLE;
+  
+  return AUDIO_REFILL_INTERVAL;
+}
+
+uint32_t patternTask(uint32_t now) {
+  uint32_t versionBefore = frameVersion;
   updatePatterns();
+  // A pattern that keeps changing the frame keeps the clock up between steps;
+  // a static frame leaves it at the minimum
+  powerHold(POWER_LOCK_ANIMATION, frameVersion != versionBefore && shouldShowLEDs());
+  showFrame();
   
-  // Handle WiFi AP requests
-  if (wifiAPEnabled) {
-    dnsServer.processNextRequest();
-    server.handleClient();
-  }
+  if (showingModeIndicator) return MODE_INDICATOR_FRAME;
   
-  if (millis() - lastBatteryCheck > batteryCheckInterval) {
-    checkPowerSource();
-    lastBatteryCheck = millis();
+  // The timer phase only moves once per heartbeat
+  if (!shouldShowLEDs()) return HEARTBEAT_INTERVAL;
+  
+  int32_t untilNextStep = timeUntil(lastPatternUpdate + patternInterval(), now);
+  return untilNextStep > 0 ? untilNextStep : 0;
+}
+
+// After the pattern task, so a phone sees the frame that was just shown
+uint32_t previewTask(uint32_t now) {
+  if (!wifiAPEnabled) return TASK_IDLE;
+  
+  portalPreview(leds);
+  return WIFI_POLL_INTERVAL;
+}
+
+uint32_t batteryTask(uint32_t now) {
+  measureBattery();
+  checkPowerSource();
+  return batteryCheckInterval;
+}
+
+uint32_t sensorTask(uint32_t now) {
+  outputSensorData();
+  return sensorOutputInterval;
+}
+
+uint32_t saveTask(uint32_t now) {
+  saveToMemory();
+  if (!settingsChanged) return saveInterval;
+  
+  int32_t untilSave = timeUntil(lastSaveTime + saveInterval, now);
+  return untilSave > 0 ? untilSave : 0;
+}
+
+bool canLightSleep() {
+  // USB serial, the AP, the tone() LEDC channel and button debouncing all need the CPU awake
+  if (currentPowerSource != POWER_AAA) return false;
+  if (wifiAPEnabled) return false;
+  if (songState == PLAYING_SONG) return false;
+  return buttonsSettled;
+}
+
+bool canDeepSleep(uint32_t now) {
+  // Only when the LEDs are off by schedule, or the batteries are empty, and
+  // nobody has been around for a while
+  if (!canLightSleep() || showingModeIndicator) return false;
+  if (timeUntil(deepSleepAllowedAt, now) > 0) return false;
+  if (ladderLevel() == BATTERY_EMPTY) return true;
+  if (!timerEnabled || manualOverride) return false;
+  if (isInOnPhase()) return false;
+  return TIMER_CYCLE_DURATION - getElapsedCycleSeconds() > DEEP_SLEEP_MIN;
+}
+
+// Sleeps until the next ON phase (not with empty batteries) or a button; the
+// board then boots through setup()
+void enterDeepSleep() {
+  bool empty = ladderLevel() == BATTERY_EMPTY;
+  uint32_t sleepSeconds = TIMER_CYCLE_DURATION - getElapsedCycleSeconds();
+  if (empty) {
+    Serial.println("Batteries empty - deep sleep until a button is pressed");
+  } else {
+    Serial.print("Deep sleep until the ON phase: ");
+    Serial.print(sleepSeconds / 60);
+    Serial.println(" min");
   }
   
-  if (millis() - lastSensorOutput > 10000) {
-    outputSensorData();
-    lastSensorOutput = millis();
+  // Count the charge since the last battery check into RTC memory, or the
+  // sleep would start from the count of the last check
+  fuelUpdate(currentPowerSource == POWER_AAA, wifiAPEnabled, songState == PLAYING_SONG, batteryMillivolts());
+  if (fuelConsumedMah() / FUEL_SAVE_STEP_MAH != savedConsumedMah / FUEL_SAVE_STEP_MAH) markSettingsChanged();
+  if (settingsChanged) commitSettings();
+  storeDeepSleep(getTotalUptimeSeconds());
+  
+  // The pixels latch their last colour and stay powered: blank them first,
+  // then keep the data line and the buzzer low while the chip is off
+  turnOffAllLEDs();
+  showFrame();
+  gpio_hold_en((gpio_num_t)RGB_PIN);
+  gpio_hold_en((gpio_num_t)BUZZER);
+  gpio_deep_sleep_hold_en();
+  
+  // Wake-up sources stay enabled between sleeps: drop idleUntil()'s timer
+  if (empty) {
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+  } else {
+    esp_sleep_enable_timer_wakeup((uint64_t)sleepSeconds * 1000000);
   }
+  esp_deep_sleep_enable_gpio_wakeup((1ULL << BUTTON1) | (1ULL << BUTTON2), ESP_GPIO_WAKEUP_GPIO_LOW);
+  Serial.flush();
+  esp_deep_sleep_start();
+}
+
+void idleUntil(uint32_t deadline) {
+  uint32_t now = millis();
+  int32_t waitMs = timeUntil(deadline, now);
+  if (waitMs <= 0) return;
   
-  saveToMemory();
+  if (canDeepSleep(now)) {
+    enterDeepSleep();
+    return;  // host builds only: the board restarts instead
+  }
   
-  FastLED.show();
-}
\ No newline at end of file
+  if (canLightSleep()) {
+    esp_sleep_enable_timer_wakeup((uint64_t)waitMs * 1000);
+    gpio_wakeup_enable((gpio_num_t)BUTTON1, GPIO_INTR_LOW_LEVEL);
+    gpio_wakeup_enable((gpio_num_t)BUTTON2, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+    esp_light_sleep_start();
+    
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO) {
+      wakeTask(tasks[TASK_BUTTONS]);
+    }
+    lightSleepMs += millis() - now;
+    powerSlept(millis() - now);
+  } else {
+    // No GPIO wake-up here, so the buttons are polled between deadlines
+    if (waitMs > (int32_t)BUTTON_IDLE_POLL) waitMs = BUTTON_IDLE_POLL;
+    delay(waitMs);
+    idleDelayMs += waitMs;
+    wakeTask(tasks[TASK_BUTTONS]);
+  }
+}
+
+void loop() {
+  uint32_t nextDeadline = runDueTasks(tasks, NUM_TASKS);
+  idleUntil(nextDeadline);
+}
@@ -0,0 +1,327 @@
+#include "patterns.h"
+#include "frame_baker.h"
+
+PatternState patternState;
+
+static CRGB redOrGreen(bool isRed) {
+  return isRed ? CRGB::Red : CRGB::Green;
+}
+
+// Fills the frame unless it already shows 'color'
+static bool fillIfChanged(CRGB* leds, const CRGB& color) {
+  for (int i = 0; i < NUM_LEDS; i++) {
+    if (!(leds[i] == color)) {
+      fill_solid(leds, NUM_LEDS, color);
+      return true;
+    }
+  }
+  return false;
+}
+
+static void initNothing(PatternState& state, CRGB* leds, const CRGB& color) {
+}
+
+// ---- Static color / off ----
+
+static void initSolid(PatternState& state, CRGB* leds, const CRGB& color) {
+  state.solid.color = color;
+  fill_solid(leds, NUM_LEDS, color);
+}
+
+static bool stepSolid(PatternState& state, CRGB* leds) {
+  return fillIfChanged(leds, state.solid.color);
+}
+
+static bool stepOff(PatternState& state, CRGB* leds) {
+  return fillIfChanged(leds, CRGB::Black);
+}
+
+// ---- Random scatter ----
+
+static void initScatter(PatternState& state, CRGB* leds, const CRGB& color) {
+  for (int i = 0; i < NUM_LEDS; i++) {
+    leds[i] = random(2) == 0 ? CRGB::Red : CRGB::Green;
+  }
+}
+
+static bool stepScatter(PatternState& state, CRGB* leds) {
+  for (int i = 0; i < NUM_LEDS; i++) {
+    if (random8(4) == 0) {
+      leds[i] = random8(2) == 0 ? CRGB::Red : CRGB::Green;
+    }
+  }
+  return true;
+}
+
+// ---- Random blink ----
+
+static void initBlink(PatternState& state, CRGB* leds, const CRGB& color) {
+  memset(state.blink.leds, 0, sizeof(state.blink.leds));
+}
+
+static bool stepBlink(PatternState& state, CRGB* leds) {
+  BlinkState& s = state.blink;
+  for (int i = 0; i < 3; i++) {
+    if (s.leds[i] < NUM_LEDS) {
+      leds[s.leds[i]] = CRGB::Black;
+    }
+  }
+
+  for (int i = 0; i < 3; i++) {
+    s.leds[i] = random8(NUM_LEDS);
+    leds[s.leds[i]] = random8(2) == 0 ? CRGB::Red : CRGB::Green;
+  }
+  return true;
+}
+
+// ---- Fade between random red/green frames ----
+
+static void initFade(PatternState& state, CRGB* leds, const CRGB& color) {
+  state.fade.progress = 0;
+  state.fade.needNewTarget = true;
+}
+
+static bool stepFade(PatternState& state, CRGB* leds) {
+  FadeState& s = state.fade;
+  if (s.needNewTarget) {
+    for (int i = 0; i < NUM_LEDS; i++) {
+      s.current[i] = leds[i];
+      s.target[i] = random8(2) == 0 ? CRGB::Red : CRGB::Green;
+    }
+    s.needNewTarget = false;
+    s.progress = 0;
+  }
+
+  s.progress += 4;
+  for (int i = 0; i < NUM_LEDS; i++) {
+    leds[i] = blend(s.current[i], s.target[i], s.progress);
+  }
+
+  if (s.progress >= 255) {
+    s.needNewTarget = true;
+  }
+  return true;
+}
+
+// ---- Sparkle ----
+
+static void initSparkle(PatternState& state, CRGB* leds, const CRGB& color) {
+  memset(&state.sparkle, 0, sizeof(state.sparkle));
+}
+
+static bool stepSparkle(PatternState& state, CRGB* leds) {
+  SparkleState& s = state.sparkle;
+  if (random8(3) == 0) {
+    uint8_t pos = random8(NUM_LEDS);
+    if (s.brightness[pos] == 0) {
+      s.brightness[pos] = 255;
+      s.colors[pos] = random8(2);
+    }
+  }
+
+  for (int i = 0; i < NUM_LEDS; i++) {
+    if (s.brightness[i] > 0) {
+      leds[i] = redOrGreen(s.colors[i] == 0);
+      leds[i].nscale8(s.brightness[i]);
+      s.brightness[i] = (s.brightness[i] * 3) >> 2;
+    } else {
+      leds[i] = CRGB::Black;
+    }
+  }
+  return true;
+}
+
+// ---- Firework ----
+
+static void initFirework(PatternState& state, CRGB* leds, const CRGB& color) {
+  state.firework.position = -1;
+}
+
+static bool stepFirework(PatternState& state, CRGB* leds) {
+  FireworkState& s = state.firework;
+  fill_solid(leds, NUM_LEDS, CRGB::Black);
+
+  if (s.position == -1) {
+    s.position = 0;
+    s.phase = 0;
+    s.brightness = 255;
+    s.isRed = random8(2) == 0;
+  }
+
+  switch (s.phase) {
+    case 0:
+      leds[s.position] = redOrGreen(s.isRed);
+      leds[s.position].nscale8(s.brightness);
+      s.position++;
+      if (s.position >= NUM_LEDS/2) {
+        s.phase = 1;
+      }
+      break;
+
+    case 1:
+      for (int i = 0; i < NUM_LEDS; i++) {
+        if (random8(2) == 0) {
+          leds[i] = redOrGreen(s.isRed);
+          leds[i].nscale8(s.brightness);
+        }
+      }
+      s.brightness = (s.brightness * 7) >> 3;
+      if (s.brightness < 40) {
+        s.phase = 2;
+      }
+      break;
+
+    case 2:
+      s.position = -1;
+      break;
+  }
+  return true;
+}
+
+// ---- Meteor ----
+
+static void initMeteor(PatternState& state, CRGB* leds, const CRGB& color) {
+  state.meteor.pos = -1;
+  state.meteor.isRed = true;
+}
+
+static bool stepMeteor(PatternState& state, CRGB* leds) {
+  MeteorState& s = state.meteor;
+  for (int i = 0; i < NUM_LEDS; i++) {
+    leds[i].nscale8(192);
+  }
+
+  if (s.pos == -1) {
+    s.pos = NUM_LEDS;
+    s.isRed = !s.isRed;
+    for (int i = 0; i < 3; i++) {
+      s.tail[i] = 255 - (i * 64);
+    }
+  }
+
+  s.pos--;
+
+  for (int i = 0; i < 3; i++) {
+    int pos = s.pos + i;
+    if (pos >= 0 && pos < NUM_LEDS) {
+      leds[pos] = redOrGreen(s.isRed);
+      leds[pos].nscale8(s.tail[i]);
+    }
+  }
+
+  if (s.pos < -3) {
+    s.pos = -1;
+  }
+  return true;
+}
+
+// ---- Baked patterns ----
+// These are periodic and don't depend on anything but the step number, so their
+// whole cycle is computed at compile time (frame k = step k after init) and the
+// step function only copies the next frame out of flash.
+
+typedef uint8_t Frame[NUM_LEDS][3];
+
+const BakedColor RED = CRGB::Red;
+const BakedColor GREEN = CRGB::Green;
+
+constexpr BakedColor redOrGreenColor(bool isRed) {
+  return isRed ? RED : GREEN;
+}
+
+// Alternating red/green, swapping every step
+constexpr void rainbowFrame(uint16_t k, Frame& frame) {
+  uint8_t colorStep = k + 1;
+  for (int i = 0; i < NUM_LEDS; i++) {
+    baker::setPixel(frame, i, redOrGreenColor(((colorStep + i) % 2) == 0));
+  }
+}
+
+// Three pixels fading out behind the head; color swaps each lap
+const uint8_t snakeLength = 3;
+
+constexpr void snakeFrame(uint16_t k, Frame& frame) {
+  uint8_t headPos = (k + 1) % NUM_LEDS;
+  bool isRed = ((k + 1) / NUM_LEDS) % 2 == 0;
+  for (int i = 0; i < snakeLength; i++) {
+    int pos = (headPos - i + NUM_LEDS) % NUM_LEDS;
+    baker::setPixel(frame, pos, redOrGreenColor(isRed), 255 - (i * 255 / snakeLength));
+  }
+}
+
+// Single pixel running along the strip; color swaps each lap
+constexpr void chaseFrame(uint16_t k, Frame& frame) {
+  bool isRed = (k / NUM_LEDS) % 2 == 0;
+  baker::setPixel(frame, k % NUM_LEDS, redOrGreenColor(isRed));
+}
+
+// sin8 brightness wave over alternating red/green pixels
+const uint8_t waveStep = 10;
+
+constexpr void waveFrame(uint16_t k, Frame& frame) {
+  uint8_t offset = (k + 1) * waveStep;
+  for (int i = 0; i < NUM_LEDS; i++) {
+    baker::setPixel(frame, i, redOrGreenColor(i % 2 == 0), baker::sin8(offset + (i * 255 / NUM_LEDS)));
+  }
+}
+
+// Red/green stripes moving one pixel every two steps
+const uint8_t stripeWidth = 2;
+
+constexpr void candyCaneFrame(uint16_t k, Frame& frame) {
+  uint8_t offset = (k + 1) % (NUM_LEDS * 2);
+  for (int i = 0; i < NUM_LEDS; i++) {
+    baker::setPixel(frame, i, redOrGreenColor(((i + offset/2) / stripeWidth) % 2 == 0));
+  }
+}
+
+// The wave offset wraps at 256, so its cycle is 256 / gcd(waveStep, 256) steps
+constexpr uint16_t gcd(uint16_t a, uint16_t b) {
+  return b == 0 ? a : gcd(b, a % b);
+}
+
+constexpr auto rainbowFrames PROGMEM = bakeFrames<2, NUM_LEDS>(rainbowFrame);
+constexpr auto snakeFrames PROGMEM = bakeFrames<NUM_LEDS * 2, NUM_LEDS>(snakeFrame);
+constexpr auto chaseFrames PROGMEM = bakeFrames<NUM_LEDS * 2, NUM_LEDS>(chaseFrame);
+constexpr auto waveFrames PROGMEM = bakeFrames<256 / gcd(waveStep, 256), NUM_LEDS>(waveFrame);
+constexpr auto candyCaneFrames PROGMEM = bakeFrames<NUM_LEDS * 2, NUM_LEDS>(candyCaneFrame);
+
+static void initBaked(PatternState& state, CRGB* leds, const CRGB& color) {
+  state.baked.frame = 0;
+}
+
+template <const auto& animation>
+static bool stepBaked(PatternState& state, CRGB* leds) {
+  BakedState& s = state.baked;
+  memcpy_P(leds, animation.rgb[s.frame], sizeof(animation.rgb[0]));
+  s.frame = (s.frame + 1) % animation.frameCount();
+  return true;
+}
+
+static_assert(sizeof(CRGB) == 3, "baked frames are copied straight into leds[]");
+
+// Indexed by DisplayMode. Static patterns still step once a second so the
+// frame heals if something else drew over it.
+constexpr Pattern patterns[NUM_DISPLAY_MODES] = {
+  {"STATIC",    "Static",         initSolid,     stepSolid,     1000, sizeof(SolidState)},
+  {"SCATTER",   "Random Scatter", initScatter,   stepScatter,   1000, 0},
+  {"RAINBOW",   "Rainbow",        initBaked,     stepBaked<rainbowFrames>,    600, sizeof(BakedState)},
+  {"SNAKE",     "Snake",          initBaked,     stepBaked<snakeFrames>,      800, sizeof(BakedState)},
+  {"BLINK",     "Random Blink",   initBlink,     stepBlink,      600, sizeof(BlinkState)},
+  {"CHASE",     "Chase",          initBaked,     stepBaked<chaseFrames>,      720, sizeof(BakedState)},
+  {"WAVE",      "Wave",           initBaked,     stepBaked<waveFrames>,       480, sizeof(BakedState)},
+  {"FADE",      "Fade Random",    initFade,      stepFade,       200, sizeof(FadeState)},
+  {"SPARKLE",   "Sparkle",        initSparkle,   stepSparkle,    200, sizeof(SparkleState)},
+  {"FIREWORK",  "Firework",       initFirework,  stepFirework,   400, sizeof(FireworkState)},
+  {"METEOR",    "Meteor",         initMeteor,    stepMeteor,     200, sizeof(MeteorState)},
+  {"CANDY",     "Candy Cane",     initBaked,     stepBaked<candyCaneFrames>,  600, sizeof(BakedState)},
+  {"OFF",       "Off",            initNothing,   stepOff,       1000, 0},
+};
+
+static_assert(sizeof(patterns) / sizeof(patterns[0]) == NUM_DISPLAY_MODES, "one registry entry per DisplayMode");
+
+void beginPattern(DisplayMode mode, CRGB* leds, const CRGB& color) {
+  memset((void*)&patternState, 0, patterns[mode].stateSize);
+  fill_solid(leds, NUM_LEDS, CRGB::Black);
+  patterns[mode].init(patternState, leds, color);
+}
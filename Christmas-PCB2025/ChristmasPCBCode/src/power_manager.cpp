@@ -0,0 +1,143 @@
+#include "power_manager.h"
+#include <esp_pm.h>
+
+static const uint32_t levelMhz[NUM_POWER_LEVELS] = {160, 80, 40};
+
+static const PowerLevel lockLevel[NUM_POWER_LOCKS] = {
+  POWER_160MHZ,  // USB
+  POWER_160MHZ,  // WiFi
+  POWER_80MHZ,   // song
+  POWER_80MHZ,   // animation
+  POWER_80MHZ    // show
+};
+
+static const char* const lockNames[NUM_POWER_LOCKS] = {"usb", "wifi", "song", "animation", "show"};
+
+// Rough supply current of the C3 with the radio off (datasheet, CPU running
+// and in light sleep); only used for the duty figure and the fuel gauge
+static const uint32_t levelMicroamps[NUM_POWER_LEVELS] = {20000, 15000, 9000};
+static const uint32_t SLEEP_MICROAMPS = 130;
+
+static bool pmEnabled = false;
+static esp_pm_lock_handle_t pmLocks[NUM_POWER_LOCKS];
+static bool held[NUM_POWER_LOCKS];
+static PowerLevel level = POWER_160MHZ;  // board_build.f_cpu at boot
+static uint32_t spanStart = 0;           // millis() when the clock last changed
+static uint32_t spanSleep = 0;           // light sleep since then
+static PowerStats stats;
+
+// Books the time since the last change to the current clock
+static void closeSpan(uint32_t now) {
+  uint32_t span = now - spanStart;
+  stats.awakeMs[level] += span > spanSleep ? span - spanSleep : 0;
+  spanStart = now;
+  spanSleep = 0;
+}
+
+static void applyLevel() {
+  PowerLevel wanted = POWER_40MHZ;
+  for (uint8_t i = 0; i < NUM_POWER_LOCKS; i++) {
+    if (held[i] && lockLevel[i] < wanted) wanted = lockLevel[i];
+  }
+  if (wanted == level) return;
+
+  closeSpan(millis());
+  level = wanted;
+  stats.clockChanges++;
+  // With esp_pm the driver has already followed the locks
+  if (!pmEnabled) setCpuFrequencyMhz(levelMhz[level]);
+}
+
+void powerBegin() {
+  esp_pm_config_esp32c3_t config = {};
+  config.max_freq_mhz = levelMhz[POWER_160MHZ];
+  config.min_freq_mhz = levelMhz[POWER_40MHZ];
+  config.light_sleep_enable = false;  // idleUntil() sleeps with the button wake-ups
+  pmEnabled = esp_pm_configure(&config) == ESP_OK;
+
+  for (uint8_t i = 0; pmEnabled && i < NUM_POWER_LOCKS; i++) {
+    if (pmLocks[i]) continue;
+    esp_pm_lock_type_t type = lockLevel[i] == POWER_160MHZ ? ESP_PM_CPU_FREQ_MAX : ESP_PM_APB_FREQ_MAX;
+    if (esp_pm_lock_create(type, 0, lockNames[i], &pmLocks[i]) != ESP_OK) pmEnabled = false;
+  }
+
+  // As if on USB power, at the boot clock, until checkPowerSource() knows better
+  for (uint8_t i = 0; i < NUM_POWER_LOCKS; i++) held[i] = false;
+  held[POWER_LOCK_USB] = true;
+  if (pmEnabled) esp_pm_lock_acquire(pmLocks[POWER_LOCK_USB]);
+  level = POWER_160MHZ;
+  spanStart = millis();
+  spanSleep = 0;
+
+  Serial.print("Power management: ");
+  Serial.println(pmEnabled ? "esp_pm" : "setCpuFrequencyMhz()");
+}
+
+void powerHold(PowerLock lock, bool hold) {
+  if (held[lock] == hold) return;
+  held[lock] = hold;
+  if (pmEnabled) {
+    if (hold) {
+      esp_pm_lock_acquire(pmLocks[lock]);
+    } else {
+      esp_pm_lock_release(pmLocks[lock]);
+    }
+  }
+  applyLevel();
+}
+
+void powerSlept(uint32_t ms) {
+  spanSleep += ms;
+  stats.sleepMs += ms;
+}
+
+PowerLevel powerLevel() {
+  return level;
+}
+
+const PowerStats& powerStats() {
+  closeSpan(millis());
+  return stats;
+}
+
+uint64_t powerCharge() {
+  closeSpan(millis());
+  uint64_t charge = stats.sleepMs * SLEEP_MICROAMPS;
+  for (uint8_t i = 0; i < NUM_POWER_LEVELS; i++) charge += stats.awakeMs[i] * levelMicroamps[i];
+  return charge;
+}
+
+uint32_t powerDutyPermille() {
+  uint64_t charge = powerCharge();
+  uint64_t totalMs = stats.sleepMs;
+  for (uint8_t i = 0; i < NUM_POWER_LEVELS; i++) totalMs += stats.awakeMs[i];
+  if (totalMs == 0) return 1000;
+  uint64_t full = totalMs * levelMicroamps[POWER_160MHZ];
+  return (uint32_t)((charge * 1000 + full / 2) / full);
+}
+
+void powerPrintStats() {
+  uint32_t duty = powerDutyPermille();
+  uint64_t totalMs = stats.sleepMs;
+  for (uint8_t i = 0; i < NUM_POWER_LEVELS; i++) totalMs += stats.awakeMs[i];
+  if (totalMs == 0) totalMs = 1;
+
+  Serial.print("CPU: ");
+  Serial.print(levelMhz[level]);
+  Serial.print(" MHz now; ");
+  for (uint8_t i = 0; i < NUM_POWER_LEVELS; i++) {
+    Serial.print(levelMhz[i]);
+    Serial.print(" MHz ");
+    Serial.print((unsigned long)(stats.awakeMs[i] * 100 / totalMs));
+    Serial.print("%, ");
+  }
+  Serial.print("light sleep ");
+  Serial.print((unsigned long)(stats.sleepMs * 100 / totalMs));
+  Serial.print("%; ");
+  Serial.print(stats.clockChanges);
+  Serial.print(" clock changes; current ~");
+  Serial.print(duty / 10);
+  Serial.print(".");
+  Serial.print(duty % 10);
+  Serial.println("% of 160 MHz awake");
+}
@@ -0,0 +1,18 @@
+#include "scheduler.h"
+
+uint32_t runDueTasks(Task* tasks, uint8_t count) {
+  for (uint8_t i = 0; i < count; i++) {
+    uint32_t now = millis();
+    if (timeUntil(tasks[i].due, now) <= 0) {
+      tasks[i].due = now + tasks[i].run(now);
+    }
+  }
+
+  uint32_t next = millis() + TASK_IDLE;
+  for (uint8_t i = 0; i < count; i++) {
+    if (timeUntil(tasks[i].due, next) < 0) {
+      next = tasks[i].due;
+    }
+  }
+  return next;
+}
@@ -0,0 +1,330 @@
+#include "settings_store.h"
+#include <Preferences.h>
+#include <esp_partition.h>
+#include <sys/time.h>
+
+#define STORE_NAMESPACE "xmas-pcb"
+#define SETTINGS_KEY "settings"
+#define UPTIME_KEY "uptime"          // only without the log partition
+#define UPTIME_LOG_LABEL "uptimelog"
+
+// An NVS entry takes 32 bytes of flash; a blob is an index entry, a header
+// entry and its data
+const uint32_t NVS_ENTRY_BYTES = 32;
+
+// The settings blob. Every version only adds fields at the end of
+// SettingsRecord and an existing field never changes meaning (a setting that
+// has to becomes a new field), so the version gives the record's length: an
+// older blob loads over the defaults up to its length with no migration code,
+// and a newer one is read up to the fields this firmware knows. A blob whose
+// length doesn't fit its version is rejected.
+const uint8_t SETTINGS_VERSION = 2;
+
+struct __attribute__((packed)) SettingsHeader {
+  uint8_t version;
+  uint8_t length;    // of the SettingsRecord that follows
+  uint16_t reserved;
+  uint32_t crc;      // CRC-32 of the record
+};
+
+struct __attribute__((packed)) SettingsRecord {
+  // Version 1
+  uint8_t displayMode;
+  uint8_t colorIndex;
+  uint8_t songIndex;
+  uint8_t timerEnabled;
+  uint64_t cycleStart;
+  // Version 2
+  uint16_t consumedMah;
+};
+
+// Record length by version
+static const uint8_t SETTINGS_LENGTHS[SETTINGS_VERSION + 1] = {
+  0,
+  offsetof(SettingsRecord, consumedMah),
+  sizeof(SettingsRecord)
+};
+
+// Room for blobs written by newer firmware, which may have more fields
+const size_t SETTINGS_BLOB_MAX = 64;
+
+// Log record: an erased slot reads all ones and a torn write fails the check
+struct UptimeRecord {
+  uint32_t seconds;   // 136 years
+  uint32_t inverted;  // ~seconds
+};
+const uint32_t SCAN_CHUNK = 32;  // records read at a time while scanning
+
+// Kept across resets and sleep; the magic tells it from power-on garbage
+#define RTC_UPTIME_MAGIC 0x55505431
+const int64_t RTC_AWAKE = -1;
+struct RtcUptime {
+  uint32_t magic;
+  uint32_t check;       // CRC-32 of the fields below
+  uint64_t seconds;
+  int64_t sleptAtUs;    // RTC clock when deep sleep started, RTC_AWAKE if not
+};
+RTC_NOINIT_ATTR static RtcUptime rtcUptime;
+
+static Preferences preferences;
+static StoredSettings stored;               // what NVS holds
+static const esp_partition_t* uptimeLog = nullptr;
+static uint32_t logNext = 0;                // byte offset of the next record
+static uint64_t lastLogged = 0;
+static uint64_t bootUptime = 0;
+static uint64_t currentUptime = 0;
+static StoreStats stats;
+
+static uint32_t crc32(const uint8_t* data, size_t length) {
+  uint32_t crc = 0xFFFFFFFF;
+  while (length--) {
+    crc ^= *data++;
+    for (uint8_t bit = 0; bit < 8; bit++) crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+  }
+  return ~crc;
+}
+
+static uint32_t rtcCheck() {
+  return crc32((const uint8_t*)&rtcUptime.seconds, sizeof(rtcUptime.seconds) + sizeof(rtcUptime.sleptAtUs));
+}
+
+static void setRtcUptime(uint64_t seconds, int64_t sleptAtUs = RTC_AWAKE) {
+  rtcUptime.seconds = seconds;
+  rtcUptime.sleptAtUs = sleptAtUs;
+  rtcUptime.check = rtcCheck();
+  rtcUptime.magic = RTC_UPTIME_MAGIC;
+}
+
+// The RTC timer keeps this clock running through deep sleep
+static int64_t rtcMicros() {
+  struct timeval now;
+  gettimeofday(&now, nullptr);
+  return (int64_t)now.tv_sec * 1000000 + now.tv_usec;
+}
+
+// RTC memory uptime plus the deep sleep it was saved before; 0 if invalid
+static uint64_t rtcUptimeSeconds() {
+  if (rtcUptime.magic != RTC_UPTIME_MAGIC || rtcUptime.check != rtcCheck()) return 0;
+  uint64_t seconds = rtcUptime.seconds;
+  if (rtcUptime.sleptAtUs != RTC_AWAKE) {
+    int64_t slept = rtcMicros() - rtcUptime.sleptAtUs;
+    if (slept > 0) seconds += slept / 1000000;
+  }
+  return seconds;
+}
+
+// Newest record in the log; the next one goes in the slot after it
+static uint64_t scanUptimeLog() {
+  UptimeRecord records[SCAN_CHUNK];
+  uint32_t newest = 0;
+  bool found = false;
+  logNext = 0;
+  for (uint32_t offset = 0; offset < uptimeLog->size; offset += sizeof(records)) {
+    if (esp_partition_read(uptimeLog, offset, records, sizeof(records)) != ESP_OK) break;
+    for (uint32_t i = 0; i < SCAN_CHUNK; i++) {
+      if (records[i].inverted != ~records[i].seconds) continue;
+      if (found && records[i].seconds < newest) continue;
+      newest = records[i].seconds;
+      logNext = (offset + (i + 1) * sizeof(UptimeRecord)) % uptimeLog->size;
+      found = true;
+    }
+  }
+  return newest;
+}
+
+static void appendUptime(uint64_t seconds) {
+  UptimeRecord record = {(uint32_t)seconds, ~(uint32_t)seconds};
+  UptimeRecord slot;
+
+  // A new sector is erased first (the oldest records go); slots a torn
+  // write left dirty are skipped
+  while (true) {
+    if (logNext % SPI_FLASH_SEC_SIZE == 0) {
+      if (esp_partition_erase_range(uptimeLog, logNext, SPI_FLASH_SEC_SIZE) != ESP_OK) return;
+      stats.logErases++;
+      break;
+    }
+    if (esp_partition_read(uptimeLog, logNext, &slot, sizeof(slot)) != ESP_OK) return;
+    if (slot.seconds == 0xFFFFFFFF && slot.inverted == 0xFFFFFFFF) break;
+    logNext = (logNext + sizeof(slot)) % uptimeLog->size;
+  }
+
+  if (esp_partition_write(uptimeLog, logNext, &record, sizeof(record)) != ESP_OK) return;
+  logNext = (logNext + sizeof(record)) % uptimeLog->size;
+  stats.logRecords++;
+  stats.flashBytes += sizeof(record);
+}
+
+static void logUptime(uint64_t seconds) {
+  if (uptimeLog) {
+    appendUptime(seconds);
+  } else {
+    // Partition table from before the log (boards updated over the air)
+    preferences.begin(STORE_NAMESPACE, false);
+    preferences.putULong64(UPTIME_KEY, seconds);
+    preferences.end();
+    stats.nvsWrites++;
+    stats.flashBytes += NVS_ENTRY_BYTES;
+  }
+  lastLogged = seconds;
+}
+
+static void toRecord(const StoredSettings& settings, SettingsRecord& record) {
+  record.displayMode = settings.displayMode;
+  record.colorIndex = settings.colorIndex;
+  record.songIndex = settings.songIndex;
+  record.timerEnabled = settings.timerEnabled;
+  record.cycleStart = settings.cycleStart;
+  record.consumedMah = settings.consumedMah;
+}
+
+static void fromRecord(const SettingsRecord& record, StoredSettings& settings) {
+  settings.displayMode = record.displayMode;
+  settings.colorIndex = record.colorIndex;
+  settings.songIndex = record.songIndex;
+  settings.timerEnabled = record.timerEnabled;
+  settings.cycleStart = record.cycleStart;
+  settings.consumedMah = record.consumedMah;
+}
+
+// One read: false if there is no blob or it fails the checks
+static bool loadBlob(StoredSettings& settings) {
+  uint8_t blob[SETTINGS_BLOB_MAX];
+  size_t length = preferences.getBytes(SETTINGS_KEY, blob, sizeof(blob));
+  if (length < sizeof(SettingsHeader)) return false;
+
+  SettingsHeader header;
+  memcpy(&header, blob, sizeof(header));
+  const uint8_t* data = blob + sizeof(header);
+  bool lengthFits = header.version <= SETTINGS_VERSION ? header.length == SETTINGS_LENGTHS[header.version]
+                                                      : header.length >= sizeof(SettingsRecord);
+  if (header.version == 0 || !lengthFits || header.length > length - sizeof(header) || crc32(data, header.length) != header.crc) {
+    Serial.println("Settings blob is corrupt, using defaults");
+    return false;
+  }
+
+  SettingsRecord record;
+  toRecord(settings, record);  // defaults for fields an older blob doesn't have
+  memcpy(&record, data, header.length < sizeof(record) ? header.length : sizeof(record));
+  fromRecord(record, settings);
+  return true;
+}
+
+static void writeBlob(const StoredSettings& settings) {
+  uint8_t blob[sizeof(SettingsHeader) + sizeof(SettingsRecord)];
+  SettingsRecord record;
+  toRecord(settings, record);
+  SettingsHeader header = {SETTINGS_VERSION, sizeof(record), 0, crc32((const uint8_t*)&record, sizeof(record))};
+  memcpy(blob, &header, sizeof(header));
+  memcpy(blob + sizeof(header), &record, sizeof(record));
+
+  preferences.putBytes(SETTINGS_KEY, blob, sizeof(blob));
+  stats.commits++;
+  stats.nvsWrites++;
+  stats.flashBytes += (2 + (sizeof(blob) + NVS_ENTRY_BYTES - 1) / NVS_ENTRY_BYTES) * NVS_ENTRY_BYTES;
+}
+
+// Settings and uptime as firmware before the blob stored them, key by key
+static const char* const legacyKeys[] = {
+  "displayMode", "colorIndex", "songIndex", "timerEnabled",
+  "cycleStartLow", "cycleStartHigh", "uptimeLow", "uptimeHigh"
+};
+
+static bool loadLegacyKeys(StoredSettings& settings, uint64_t& uptime) {
+  bool found = false;
+  for (const char* key : legacyKeys) found |= preferences.isKey(key);
+  if (!found) return false;
+  settings.displayMode = preferences.getUChar("displayMode", settings.displayMode);
+  settings.colorIndex = preferences.getUChar("colorIndex", settings.colorIndex);
+  settings.songIndex = preferences.getUChar("songIndex", settings.songIndex);
+  settings.timerEnabled = preferences.getBool("timerEnabled", settings.timerEnabled);
+  uint32_t cycleStartLow = preferences.getULong("cycleStartLow", (uint32_t)settings.cycleStart);
+  uint32_t cycleStartHigh = preferences.getULong("cycleStartHigh", (uint32_t)(settings.cycleStart >> 32));
+  settings.cycleStart = ((uint64_t)cycleStartHigh << 32) | cycleStartLow;
+  uptime = ((uint64_t)preferences.getULong("uptimeHigh", 0) << 32) | preferences.getULong("uptimeLow", 0);
+  return true;
+}
+
+void storeBegin(StoredSettings& settings, uint64_t& uptimeSeconds) {
+  uint64_t nvsUptime = 0;
+  preferences.begin(STORE_NAMESPACE, true);
+  bool loaded = loadBlob(settings);
+  bool migrate = !loaded && loadLegacyKeys(settings, nvsUptime);
+  if (!migrate) nvsUptime = preferences.getULong64(UPTIME_KEY, 0);
+  preferences.end();
+  stored = settings;
+
+  uptimeLog = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, UPTIME_LOG_LABEL);
+  lastLogged = uptimeLog ? scanUptimeLog() : nvsUptime;
+
+  // The newest of the log, NVS and RTC memory
+  uint64_t seconds = lastLogged > nvsUptime ? lastLogged : nvsUptime;
+  uint64_t rtcSeconds = rtcUptimeSeconds();
+  if (rtcSeconds > seconds) seconds = rtcSeconds;
+
+  if (migrate) {
+    // First boot after the key-per-setting layout: one blob replaces the keys
+    preferences.begin(STORE_NAMESPACE, false);
+    writeBlob(settings);
+    for (const char* key : legacyKeys) preferences.remove(key);
+    preferences.end();
+    logUptime(seconds);
+    Serial.println("Settings migrated to the settings blob");
+  }
+
+  setRtcUptime(seconds);
+  bootUptime = seconds;
+  currentUptime = seconds;
+  uptimeSeconds = seconds;
+}
+
+bool storeCommit(const StoredSettings& settings) {
+  SettingsRecord current;
+  SettingsRecord next;
+  toRecord(stored, current);
+  toRecord(settings, next);
+  if (memcmp(&current, &next, sizeof(next)) == 0) return false;
+
+  preferences.begin(STORE_NAMESPACE, false);
+  writeBlob(settings);
+  preferences.end();
+  stored = settings;
+  return true;
+}
+
+void storeUptime(uint64_t uptimeSeconds) {
+  currentUptime = uptimeSeconds;
+  setRtcUptime(uptimeSeconds);
+  if (uptimeSeconds - lastLogged >= UPTIME_LOG_INTERVAL) logUptime(uptimeSeconds);
+}
+
+void storeDeepSleep(uint64_t uptimeSeconds) {
+  currentUptime = uptimeSeconds;
+  if (uptimeSeconds != lastLogged) logUptime(uptimeSeconds);
+  setRtcUptime(uptimeSeconds, rtcMicros());
+}
+
+const StoreStats& storeStats() {
+  return stats;
+}
+
+void storePrintStats() {
+  uint64_t seconds = currentUptime - bootUptime;
+  Serial.print("Flash: ");
+  Serial.print(stats.flashBytes);
+  Serial.print(" B written");
+  if (seconds > 0) {
+    Serial.print(" (");
+    Serial.print((unsigned long)((uint64_t)stats.flashBytes * 3600 / seconds));
+    Serial.print(" B/h)");
+  }
+  Serial.print(", ");
+  Serial.print(stats.commits);
+  Serial.print(" settings commits, ");
+  Serial.print(stats.nvsWrites);
+  Serial.print(" NVS writes, ");
+  Serial.print(stats.logRecords);
+  Serial.print(" uptime records, ");
+  Serial.print(stats.logErases);
+  Serial.println(uptimeLog ? " sector erases" : " sector erases (no log partition, uptime in NVS)");
+}
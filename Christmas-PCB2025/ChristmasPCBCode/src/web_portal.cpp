@@ -0,0 +1,587 @@
+#include "web_portal.h"
+#include <ESPAsyncWebServer.h>
+#include <atomic>
+#include "christmas_songs.h"
+#include "patterns.h"
+#include "web_assets.h"
+
+static AsyncWebServer server(80);
+static AsyncWebSocket socket("/ws");
+
+// Single-producer (AsyncTCP task) / single-consumer (loop) ring buffer
+static PortalCommand commandQueue[PORTAL_QUEUE_LENGTH];
+static std::atomic<uint16_t> queueHead(0);   // next command loop() takes
+static std::atomic<uint16_t> queueTail(0);   // next slot a handler fills
+// PortalState, packed into two words so handlers can read it whole: stateVersion
+// is odd while loop() is writing them (a sequence lock)
+static std::atomic<uint32_t> publishedState(0);
+static std::atomic<uint32_t> publishedDetail(0);
+static std::atomic<uint32_t> stateVersion(0);
+static PortalStats stats;
+static bool routesAdded = false;
+
+// Live preview: socket ids of the phones watching (0 = free slot). Only the
+// AsyncTCP task changes the slots; loop() reads them.
+static std::atomic<uint32_t> previewClients[PORTAL_MAX_PREVIEWS];
+static std::atomic<bool> previewKeyNeeded(false);
+static uint8_t previewSent[NUM_LEDS][3];  // what the phones show now
+static uint32_t lastPreviewSend = 0;
+static uint32_t lastKeyframe = 0;
+
+// Captive-portal probes: every OS fetches one of these URLs (again and again) to
+// test for internet access. They get a bodiless redirect instead of the page;
+// the full page is only sent when it is actually opened.
+struct PortalProbe {
+  const char* uri;
+  const char* os;
+  uint32_t hits;
+  uint32_t handlerUs;  // total time spent answering
+};
+
+static PortalProbe portalProbes[] = {
+  {"/generate_204", "Android", 0, 0},
+  {"/gen_204", "Android", 0, 0},
+  {"/hotspot-detect.html", "Apple", 0, 0},
+  {"/connecttest.txt", "Windows", 0, 0},
+  {"/fwlink", "Windows", 0, 0},
+  {"/canonical.html", "Ubuntu", 0, 0},
+  {"/success.txt", "Firefox", 0, 0}
+};
+static const uint8_t NUM_PORTAL_PROBES = sizeof(portalProbes) / sizeof(portalProbes[0]);
+static const uint16_t PROBE_REPLY_BYTES = 130;  // status line, Location, Content-Type/Length, Connection
+static uint32_t pageServes = 0;
+static uint32_t pageServeUs = 0;
+
+static uint16_t queueFree() {
+  return PORTAL_QUEUE_LENGTH - (uint16_t)(queueTail.load(std::memory_order_relaxed) -
+                                          queueHead.load(std::memory_order_acquire));
+}
+
+// Only called after queueFree() said there is room
+static void postCommand(PortalCommandType type, int16_t value) {
+  uint16_t tail = queueTail.load(std::memory_order_relaxed);
+  commandQueue[tail % PORTAL_QUEUE_LENGTH] = {type, value};
+  queueTail.store(tail + 1, std::memory_order_release);
+  stats.commands++;
+}
+
+static bool validCommand(uint8_t type, int value) {
+  switch (type) {
+    case PORTAL_SET_BRIGHTNESS: return value >= 10 && value <= 255;
+    // Web numbering: two static colors, then every other mode
+    case PORTAL_SET_PATTERN: return value >= 0 && value <= NUM_DISPLAY_MODES;
+    case PORTAL_SET_TIMER: return value == 0 || value == 1;
+    case PORTAL_PLAY_SONG: return value >= 0 && value < NUM_CHRISTMAS_SONGS;
+    case PORTAL_STOP_SONG: return true;
+  }
+  return false;
+}
+
+static uint32_t packState(const PortalState& state) {
+  return state.brightness | (uint32_t)state.pattern << 8 | (uint32_t)state.timer << 16 | (uint32_t)state.song << 24;
+}
+
+static uint32_t packDetail(const PortalState& state) {
+  return state.timerOnPhase | (uint32_t)state.battery << 8 | (uint32_t)state.minutesLeft << 16;
+}
+
+// Consistent copy of the published state (handlers only); returns its version
+static uint32_t readState(PortalState& state) {
+  uint32_t version;
+  uint32_t packed;
+  uint32_t detail;
+  do {
+    version = stateVersion.load(std::memory_order_acquire);
+    packed = publishedState.load(std::memory_order_relaxed);
+    detail = publishedDetail.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while ((version & 1) || version != stateVersion.load(std::memory_order_relaxed));
+
+  state.brightness = packed;
+  state.pattern = packed >> 8;
+  state.timer = packed >> 16;
+  state.song = packed >> 24;
+  state.timerOnPhase = detail;
+  state.battery = detail >> 8;
+  state.minutesLeft = detail >> 16;
+  return version;
+}
+
+// Appends to a fixed buffer; output is cut short rather than overflowing
+struct JsonBuffer {
+  char* text;
+  size_t size;
+  size_t length;
+
+  void raw(const char* s) {
+    while (*s && length + 1 < size) text[length++] = *s++;
+    text[length] = '\0';
+  }
+
+  void string(const char* s) {
+    raw("\"");
+    for (; *s && length + 2 < size; s++) {
+      if (*s == '"' || *s == '\\') text[length++] = '\\';
+      text[length++] = *s;
+    }
+    text[length] = '\0';
+    raw("\"");
+  }
+
+  void number(long value) {
+    char digits[12];
+    snprintf(digits, sizeof(digits), "%ld", value);
+    raw(digits);
+  }
+};
+
+// Web pattern numbers 0 and 1 are the static colors, then every other mode
+static const char* const staticColorLabels[] = {"Static Red", "Static Green"};
+static const uint8_t NUM_WEB_PATTERNS = 2 + NUM_DISPLAY_MODES - 1;
+
+static const char* webPatternLabel(uint8_t pattern) {
+  if (pattern < 2) return staticColorLabels[pattern];
+  return pattern < NUM_WEB_PATTERNS ? patterns[pattern - 1].label : "";
+}
+
+// Only touched by handlers (all on the AsyncTCP task)
+static char catalogJson[1024];
+static char catalogEtag[12];
+static char stateJson[320];
+static char stateEtag[24];
+static uint32_t stateJsonVersion = 1;  // odd: nothing built yet
+static uint16_t bootTag = 0;           // keeps ETags from an earlier boot from matching
+
+// "Playing: <song>" for every song, written once so /play replies from a fixed buffer
+#define PLAY_REPLY_LENGTH 48
+static char playReplies[NUM_CHRISTMAS_SONGS][PLAY_REPLY_LENGTH];
+
+static void buildCatalog() {
+  JsonBuffer json = {catalogJson, sizeof(catalogJson), 0};
+  json.raw("{\"leds\":");
+  json.number(NUM_LEDS);
+  json.raw(",\"patterns\":[");
+  for (uint8_t i = 0; i < NUM_WEB_PATTERNS; i++) {
+    if (i > 0) json.raw(",");
+    json.string(webPatternLabel(i));
+  }
+  json.raw("],\"songs\":[");
+  for (uint8_t i = 0; i < NUM_CHRISTMAS_SONGS; i++) {
+    if (i > 0) json.raw(",");
+    json.string(songNames[i]);
+  }
+  json.raw("]}");
+
+  // FNV-1a of the content: the catalog only changes with the firmware
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < json.length; i++) hash = (hash ^ (uint8_t)catalogJson[i]) * 16777619u;
+  snprintf(catalogEtag, sizeof(catalogEtag), "\"%08lx\"", (unsigned long)hash);
+}
+
+static void buildState() {
+  PortalState state;
+  uint32_t version = readState(state);
+  if (version == stateJsonVersion) return;
+
+  JsonBuffer json = {stateJson, sizeof(stateJson), 0};
+  json.raw("{\"brightness\":");
+  json.number(state.brightness);
+  json.raw(",\"pattern\":");
+  json.number(state.pattern);
+  json.raw(",\"patternName\":");
+  json.string(webPatternLabel(state.pattern));
+  json.raw(",\"timer\":{\"enabled\":");
+  json.raw(state.timer ? "true" : "false");
+  if (state.timer) {
+    json.raw(",\"phase\":");
+    json.raw(state.timerOnPhase ? "\"on\"" : "\"off\"");
+    json.raw(",\"minutesLeft\":");
+    json.number(state.minutesLeft);
+  }
+  json.raw("},\"power\":");
+  json.raw(state.battery ? "\"battery\"" : "\"usb\"");
+  json.raw(",\"song\":");
+  if (state.song > 0 && state.song <= NUM_CHRISTMAS_SONGS) {
+    json.raw("{\"index\":");
+    json.number(state.song - 1);
+    json.raw(",\"name\":");
+    json.string(songNames[state.song - 1]);
+    json.raw("}");
+  } else {
+    json.raw("null");
+  }
+  json.raw("}");
+
+  snprintf(stateEtag, sizeof(stateEtag), "\"%04x-%lu\"", bootTag, (unsigned long)(version / 2));
+  stateJsonVersion = version;
+}
+
+// 304 if the phone has this version, else the JSON (copied when it may be
+// rebuilt while the response is still going out)
+static void sendJson(AsyncWebServerRequest* request, const char* json, const char* etag, bool copy) {
+  AsyncWebServerResponse* response;
+  if (request->hasHeader("If-None-Match") && request->header("If-None-Match") == etag) {
+    response = request->beginResponse(304);
+  } else if (copy) {
+    response = request->beginResponse(200, "application/json", json);
+  } else {
+    response = request->beginResponse(200, "application/json", (const uint8_t*)json, strlen(json));
+  }
+  response->addHeader("Cache-Control", "no-cache");
+  response->addHeader("ETag", etag);
+  request->send(response);
+}
+
+static void stateFrame(uint32_t packed, uint8_t (&frame)[PORTAL_STATE_FRAME_LENGTH]) {
+  frame[0] = PORTAL_STATE_FRAME;
+  for (uint8_t i = 0; i < 4; i++) frame[i + 1] = packed >> (8 * i);
+}
+
+// Reads a query argument in place: 1-5 digits and nothing else, so "12abc" or
+// "-1" is rejected instead of turning into 12 or a huge index
+static bool intParam(AsyncWebServerRequest* request, const char* name, int& value) {
+  const AsyncWebParameter* param = request->getParam(name);
+  if (!param) return false;
+  const char* text = param->value().c_str();
+  int parsed = 0;
+  uint8_t digits = 0;
+  for (; *text; text++, digits++) {
+    if (*text < '0' || *text > '9' || digits == 5) return false;
+    parsed = parsed * 10 + (*text - '0');
+  }
+  if (digits == 0) return false;
+  value = parsed;
+  return true;
+}
+
+// Sends a reply straight from text, which must outlive the response (a literal
+// or a static buffer); send(code, type, String) would copy it to the heap
+static void sendText(AsyncWebServerRequest* request, int code, const char* text) {
+  request->send(request->beginResponse(code, "text/plain", (const uint8_t*)text, strlen(text)));
+}
+
+static bool queueFull(AsyncWebServerRequest* request, uint16_t needed) {
+  if (queueFree() >= needed) return false;
+  stats.dropped++;
+  sendText(request, 503, "Busy, try again");
+  return true;
+}
+
+// The portal page (web/index.html) is gzipped at build time by scripts/build_web.py
+// and streamed straight from flash. Phones that already have it get a 304.
+static void handleRoot(AsyncWebServerRequest* request) {
+  uint32_t start = micros();
+  AsyncWebServerResponse* response;
+  bool cached = request->hasHeader("If-None-Match") && request->header("If-None-Match") == WEB_INDEX_ETAG;
+  if (cached) {
+    response = request->beginResponse(304);
+  } else {
+    response = request->beginResponse(200, "text/html", webIndexGz, WEB_INDEX_GZ_LENGTH);
+    response->addHeader("Content-Encoding", "gzip");
+  }
+  response->addHeader("Cache-Control", "no-cache");  // always revalidate, the ETag makes that cheap
+  response->addHeader("ETag", WEB_INDEX_ETAG);
+  request->send(response);
+  if (!cached) {
+    pageServes++;
+    pageServeUs += micros() - start;
+  }
+}
+
+// Any answer other than the one a probe expects opens the captive-portal UI.
+// The Location header also tells the OS where the portal is.
+static void handleProbe(AsyncWebServerRequest* request, uint8_t probe) {
+  uint32_t start = micros();
+  request->redirect("http://192.168.4.1/");
+  portalProbes[probe].hits++;
+  portalProbes[probe].handlerUs += micros() - start;
+}
+
+static void handleSet(AsyncWebServerRequest* request) {
+  int brightness = 0;
+  int pattern = 0;
+  int timer = 0;
+  bool hasBrightness = intParam(request, "brightness", brightness) && validCommand(PORTAL_SET_BRIGHTNESS, brightness);
+  bool hasPattern = intParam(request, "pattern", pattern) && validCommand(PORTAL_SET_PATTERN, pattern);
+  bool hasTimer = intParam(request, "timer", timer) && validCommand(PORTAL_SET_TIMER, timer);
+
+  if (queueFull(request, hasBrightness + hasPattern + hasTimer)) return;
+  if (hasBrightness) postCommand(PORTAL_SET_BRIGHTNESS, brightness);
+  if (hasPattern) postCommand(PORTAL_SET_PATTERN, pattern);
+  if (hasTimer) postCommand(PORTAL_SET_TIMER, timer);
+  sendText(request, 200, "Settings applied!");
+}
+
+static void handlePlay(AsyncWebServerRequest* request) {
+  int songIndex = -1;
+  if (!intParam(request, "song", songIndex) || !validCommand(PORTAL_PLAY_SONG, songIndex)) {
+    sendText(request, 400, "Invalid song");
+    return;
+  }
+  if (queueFull(request, 1)) return;
+  postCommand(PORTAL_PLAY_SONG, songIndex);
+  sendText(request, 200, playReplies[songIndex]);
+}
+
+static void handleStop(AsyncWebServerRequest* request) {
+  if ((publishedState.load(std::memory_order_relaxed) >> 24) == 0) {
+    sendText(request, 200, "No song playing");
+    return;
+  }
+  if (queueFull(request, 1)) return;
+  postCommand(PORTAL_STOP_SONG, 0);
+  sendText(request, 200, "Song stopped");
+}
+
+static void handleCatalog(AsyncWebServerRequest* request) {
+  if (catalogJson[0] == '\0') buildCatalog();
+  sendJson(request, catalogJson, catalogEtag, false);
+}
+
+static void handleState(AsyncWebServerRequest* request) {
+  buildState();
+  sendJson(request, stateJson, stateEtag, true);
+  stats.stateRequests++;
+}
+
+static void handleNotFound(AsyncWebServerRequest* request) {
+  // Redirect all requests to root for captive portal
+  request->redirect("http://192.168.4.1");
+}
+
+static void setPreview(uint32_t clientId, bool on) {
+  for (std::atomic<uint32_t>& slot : previewClients) {
+    if (slot.load(std::memory_order_relaxed) == clientId) slot.store(0, std::memory_order_relaxed);
+  }
+  if (!on) return;
+  for (std::atomic<uint32_t>& slot : previewClients) {
+    if (slot.load(std::memory_order_relaxed) == 0) {
+      slot.store(clientId, std::memory_order_release);
+      previewKeyNeeded.store(true, std::memory_order_release);
+      return;
+    }
+  }
+}
+
+// Command frames: [command, value] pairs. Anything invalid is skipped; the
+// next state push puts the page right again.
+static void onSocketEvent(AsyncWebSocket* ws, AsyncWebSocketClient* client, AwsEventType type,
+                          void* arg, uint8_t* data, size_t len) {
+  if (type == WS_EVT_CONNECT) {
+    uint8_t frame[PORTAL_STATE_FRAME_LENGTH];
+    stateFrame(publishedState.load(std::memory_order_relaxed), frame);
+    client->binary(frame, sizeof(frame));
+    return;
+  }
+  if (type == WS_EVT_DISCONNECT) {
+    setPreview(client->id(), false);
+    return;
+  }
+  if (type != WS_EVT_DATA) return;
+
+  // Commands are a few bytes: only whole, unfragmented binary messages
+  AwsFrameInfo* info = (AwsFrameInfo*)arg;
+  if (!info->final || info->index != 0 || info->len != len || info->opcode != WS_BINARY) return;
+
+  stats.socketFrames++;
+  for (size_t i = 0; i + 1 < len; i += 2) {
+    if (data[i] == PORTAL_PREVIEW) {
+      setPreview(client->id(), data[i + 1] != 0);
+      continue;
+    }
+    if (!validCommand(data[i], data[i + 1])) continue;
+    if (queueFree() == 0) {
+      stats.dropped++;
+      continue;
+    }
+    postCommand((PortalCommandType)data[i], data[i + 1]);
+  }
+}
+
+void portalBegin() {
+  // Routes are added once; the server keeps them across AP sessions
+  if (!routesAdded) {
+    server.on("/", HTTP_GET, handleRoot);
+    server.on("/set", HTTP_GET, handleSet);      // Settings control
+    server.on("/play", HTTP_GET, handlePlay);    // Play song
+    server.on("/stop", HTTP_GET, handleStop);    // Stop song
+    server.on("/api/catalog", HTTP_GET, handleCatalog);
+    server.on("/api/state", HTTP_GET, handleState);
+    for (uint8_t i = 0; i < NUM_PORTAL_PROBES; i++) {
+      server.on(portalProbes[i].uri, HTTP_GET, [i](AsyncWebServerRequest* request) { handleProbe(request, i); });
+    }
+    socket.onEvent(onSocketEvent);
+    server.addHandler(&socket);
+    server.onNotFound(handleNotFound);
+    bootTag = micros() ^ (micros() >> 16);
+    for (uint8_t i = 0; i < NUM_CHRISTMAS_SONGS; i++) {
+      snprintf(playReplies[i], PLAY_REPLY_LENGTH, "Playing: %s", songNames[i]);
+    }
+    routesAdded = true;
+  }
+  server.begin();
+}
+
+void portalEnd() {
+  socket.closeAll();
+  server.end();
+  queueHead.store(queueTail.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+bool portalNextCommand(PortalCommand& command) {
+  uint16_t head = queueHead.load(std::memory_order_relaxed);
+  if (head == queueTail.load(std::memory_order_acquire)) return false;
+  command = commandQueue[head % PORTAL_QUEUE_LENGTH];
+  queueHead.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+void portalUpdate(const PortalState& state) {
+  static uint32_t lastCleanup = 0;
+  uint32_t packed = packState(state);
+  uint32_t detail = packDetail(state);
+  bool pushNeeded = packed != publishedState.load(std::memory_order_relaxed);
+  if (pushNeeded || detail != publishedDetail.load(std::memory_order_relaxed)) {
+    uint32_t version = stateVersion.load(std::memory_order_relaxed);
+    stateVersion.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    publishedState.store(packed, std::memory_order_relaxed);
+    publishedDetail.store(detail, std::memory_order_relaxed);
+    stateVersion.store(version + 2, std::memory_order_release);
+  }
+  if (pushNeeded) {
+    if (socket.count() > 0) {
+      uint8_t frame[PORTAL_STATE_FRAME_LENGTH];
+      stateFrame(packed, frame);
+      socket.binaryAll(frame, sizeof(frame));  // one buffer shared by all clients
+      stats.statePushes++;
+    }
+  }
+  if (millis() - lastCleanup >= 1000) {
+    lastCleanup = millis();
+    socket.cleanupClients();
+  }
+}
+
+void portalPreview(const CRGB* leds) {
+  uint32_t now = millis();
+  if (now - lastPreviewSend < PORTAL_PREVIEW_INTERVAL) return;
+
+  uint8_t watching = 0;
+  for (std::atomic<uint32_t>& slot : previewClients) watching += slot.load(std::memory_order_acquire) != 0;
+  if (watching == 0) return;
+
+  // A delta is only valid on top of the frame before it, so rather than let a
+  // backed-up socket drop one, nobody gets this frame; the next delta covers it
+  if (!socket.availableForWriteAll()) {
+    stats.previewSkipped++;
+    lastPreviewSend = now;
+    return;
+  }
+
+  uint8_t frame[2 + NUM_LEDS * 4];
+  size_t len = 2;
+  bool key = previewKeyNeeded.exchange(false, std::memory_order_acquire) ||
+             now - lastKeyframe >= PORTAL_KEYFRAME_INTERVAL;
+  if (!key) {
+    uint8_t changed = 0;
+    for (uint8_t i = 0; i < NUM_LEDS; i++) {
+      if (leds[i].r == previewSent[i][0] && leds[i].g == previewSent[i][1] && leds[i].b == previewSent[i][2]) continue;
+      frame[len++] = i;
+      frame[len++] = leds[i].r;
+      frame[len++] = leds[i].g;
+      frame[len++] = leds[i].b;
+      changed++;
+    }
+    if (changed == 0) return;
+    frame[0] = PORTAL_PREVIEW_DELTA;
+    frame[1] = changed;
+    key = len > 2 + NUM_LEDS * 3;  // most LEDs changed: a keyframe is smaller
+  }
+  if (key) {
+    frame[0] = PORTAL_PREVIEW_KEY;
+    frame[1] = NUM_LEDS;
+    len = 2;
+    for (uint8_t i = 0; i < NUM_LEDS; i++) {
+      frame[len++] = leds[i].r;
+      frame[len++] = leds[i].g;
+      frame[len++] = leds[i].b;
+    }
+    lastKeyframe = now;
+  }
+
+  for (std::atomic<uint32_t>& slot : previewClients) {
+    uint32_t id = slot.load(std::memory_order_acquire);
+    if (id != 0) socket.binary(id, frame, len);
+  }
+  for (uint8_t i = 0; i < NUM_LEDS; i++) {
+    previewSent[i][0] = leds[i].r;
+    previewSent[i][1] = leds[i].g;
+    previewSent[i][2] = leds[i].b;
+  }
+  lastPreviewSend = now;
+  stats.previewFrames++;
+  stats.previewBytes += len * watching;
+}
+
+const PortalStats& portalStats() {
+  return stats;
+}
+
+void portalPrintStats() {
+  uint32_t probeHits = 0;
+  uint32_t probeUs = 0;
+  for (uint8_t i = 0; i < NUM_PORTAL_PROBES; i++) {
+    probeHits += portalProbes[i].hits;
+    probeUs += portalProbes[i].handlerUs;
+  }
+  if (probeHits == 0 && pageServes == 0 && stats.commands == 0 && stats.stateRequests == 0) return;
+
+  Serial.print("Portal: page sent ");
+  Serial.print(pageServes);
+  Serial.print("x, ");
+  Serial.print(stats.commands);
+  Serial.print(" commands, ");
+  Serial.print(stats.dropped);
+  Serial.print(" busy, ");
+  Serial.print(socket.count());
+  Serial.print(" sockets, ");
+  Serial.print(stats.socketFrames);
+  Serial.print(" socket frames, ");
+  Serial.print(stats.statePushes);
+  Serial.print(" state pushes, ");
+  Serial.print(stats.stateRequests);
+  Serial.print(" state requests, ");
+  Serial.print(stats.previewFrames);
+  Serial.print(" preview frames (");
+  Serial.print(stats.previewBytes);
+  Serial.print(" B, ");
+  Serial.print(stats.previewSkipped);
+  Serial.print(" skipped), probes");
+  for (uint8_t i = 0; i < NUM_PORTAL_PROBES; i++) {
+    if (portalProbes[i].hits == 0) continue;
+    Serial.print(" ");
+    Serial.print(portalProbes[i].uri);
+    Serial.print("(");
+    Serial.print(portalProbes[i].os);
+    Serial.print(")=");
+    Serial.print(portalProbes[i].hits);
+  }
+  Serial.println();
+
+  Serial.print("Portal probes saved: ");
+  Serial.print(probeHits * (WEB_INDEX_GZ_LENGTH - PROBE_REPLY_BYTES) / 1024);
+  Serial.print(" KB");
+  if (pageServes > 0) {
+    uint32_t pageUs = pageServeUs / pageServes;
+    uint32_t savedUs = probeHits * pageUs > probeUs ? probeHits * pageUs - probeUs : 0;
+    Serial.print(", ");
+    Serial.print(savedUs / 1000);
+    Serial.print(" ms (page ");
+    Serial.print(pageUs);
+    Serial.print("us, probe ");
+    Serial.print(probeHits ? probeUs / probeHits : 0);
+    Serial.print("us)");
+  }
+  Serial.println();
+}
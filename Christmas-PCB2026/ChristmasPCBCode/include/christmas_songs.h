@@ -27,6 +27,7 @@
 #define CHRISTMAS_SONGS_H
 
 #include "pitches.h"
+#include "song_compiler.h"
 
 #ifndef REST
 #define REST 0
@@ -79,12 +80,18 @@ const char* songNames[] = {
 
 // Structure to hold song data
 struct Song {
-  const int16_t* melody;
+  PackedSong notes;  // packed from the melody at build time, play with SongDecoder
   int size;
   int baseTempo;
   const char* name;
 };
 
+// Builds a songs[] entry; the melody is compiled and packed for the given tempo
+template <const auto& melody, int tempo>
+constexpr Song makeSong(const char* name) {
+  return {packedSong<melody, tempo>.song(), songpack::noteCount<melody>, tempo, name};
+}
+
 // 1. Santa Claus Is Coming to Town
 const int16_t santaClausIsComin[] PROGMEM {
   NOTE_G4,8,
@@ -321,24 +328,24 @@ const int defaultTempos[] = {
 
 // Array of all songs
 const Song songs[] = {
-  {santaClausIsComin, sizeof(santaClausIsComin)/sizeof(int16_t)/2, 137, "Santa Claus Is Coming to Town"},
-  {jingleBells, sizeof(jingleBells)/sizeof(int16_t)/2, 180, "Jingle Bells"},
-  {weWishYou, sizeof(weWishYou)/sizeof(int16_t)/2, 160, "We Wish You a Merry Christmas"},
-  {silentNight, sizeof(silentNight)/sizeof(int16_t)/2, 130, "Silent Night"},
-  {rudolfTheRedNosed, sizeof(rudolfTheRedNosed)/sizeof(int16_t)/2, 150, "Rudolph the Red-Nosed Reindeer"},
-  {oChristmasTree, sizeof(oChristmasTree)/sizeof(int16_t)/2, 115, "O Christmas Tree"},
-  {oComeAllYe, sizeof(oComeAllYe)/sizeof(int16_t)/2, 140, "O Come All Ye Faithful"},
-  {oLittleTown, sizeof(oLittleTown)/sizeof(int16_t)/2, 125, "O Little Town of Bethlehem"},
-  {theFirstNoel, sizeof(theFirstNoel)/sizeof(int16_t)/2, 130, "The First Noel"},
-  {weThreeKings, sizeof(weThreeKings)/sizeof(int16_t)/2, 144, "We Three Kings"},
-  {whiteChristmas, sizeof(whiteChristmas)/sizeof(int16_t)/2, 155, "White Christmas"},
-  {awayInAManger, sizeof(awayInAManger)/sizeof(int16_t)/2, 125, "Away in a Manger"},
-  {carolOfTheBells, sizeof(carolOfTheBells)/sizeof(int16_t)/2, 135, "Carol of the Bells"},
-  {deckTheHalls, sizeof(deckTheHalls)/sizeof(int16_t)/2, 150, "Deck the Halls"},
-  {godRestYe, sizeof(godRestYe)/sizeof(int16_t)/2, 170, "God Rest Ye Merry Gentlemen"},
-  {goTellItOnTheMountain, sizeof(goTellItOnTheMountain)/sizeof(int16_t)/2, 140, "Go Tell It on the Mountain"},
-  {harkTheHerald, sizeof(harkTheHerald)/sizeof(int16_t)/2, 140, "Hark the Herald Angels Sing"},
-  {joyToTheWorld, sizeof(joyToTheWorld)/sizeof(int16_t)/2, 160, "Joy to the World"}
+  makeSong<santaClausIsComin, 137>("Santa Claus Is Coming to Town"),
+  makeSong<jingleBells, 180>("Jingle Bells"),
+  makeSong<weWishYou, 160>("We Wish You a Merry Christmas"),
+  makeSong<silentNight, 130>("Silent Night"),
+  makeSong<rudolfTheRedNosed, 150>("Rudolph the Red-Nosed Reindeer"),
+  makeSong<oChristmasTree, 115>("O Christmas Tree"),
+  makeSong<oComeAllYe, 140>("O Come All Ye Faithful"),
+  makeSong<oLittleTown, 125>("O Little Town of Bethlehem"),
+  makeSong<theFirstNoel, 130>("The First Noel"),
+  makeSong<weThreeKings, 144>("We Three Kings"),
+  makeSong<whiteChristmas, 155>("White Christmas"),
+  makeSong<awayInAManger, 125>("Away in a Manger"),
+  makeSong<carolOfTheBells, 135>("Carol of the Bells"),
+  makeSong<deckTheHalls, 150>("Deck the Halls"),
+  makeSong<godRestYe, 170>("God Rest Ye Merry Gentlemen"),
+  makeSong<goTellItOnTheMountain, 140>("Go Tell It on the Mountain"),
+  makeSong<harkTheHerald, 140>("Hark the Herald Angels Sing"),
+  makeSong<joyToTheWorld, 160>("Joy to the World")
 };
 
 // Function to get song data
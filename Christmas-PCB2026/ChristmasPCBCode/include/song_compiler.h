@@ -0,0 +1,257 @@
+#ifndef SONG_COMPILER_H
+#define SONG_COMPILER_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// Compile-time song compiler.
+// Melodies are written as {pitch, note type} pairs (4 = quarter, -4 = dotted
+// quarter, ...), 4 bytes per note. At build time each one is compiled and packed
+// into about one byte per note; SongDecoder streams the notes back out ready to
+// play. Durations use exactly the integer/float math the players used to do per
+// note, so playback is unchanged.
+//
+// Packed format, per song:
+//   pitches[]     distinct frequencies of the song (at most 32, 0 = rest)
+//   durationMs[]  distinct note lengths (at most 7), toneMs[] = 90% of each
+//   stream[]      one byte per note, plus escapes:
+//     ddd ppppp            note: duration d (0-6), pitch p
+//     111 0 nnnn           repeat the previous note n+1 times
+//     111 1 llll, dist     replay l+3 stream bytes starting dist bytes before
+//                          this escape (the replayed bytes never contain a replay)
+
+struct CompiledNote {
+  uint16_t frequency;   // Hz, 0 = rest
+  uint16_t durationMs;  // until the next note starts
+  uint16_t toneMs;      // how long the buzzer sounds (90% of the duration)
+};
+
+struct PackedSong {
+  const uint16_t* pitches;
+  const uint16_t* durationMs;
+  const uint16_t* toneMs;
+  const uint8_t* stream;
+  uint16_t streamLength;
+};
+
+namespace songpack {
+
+const uint8_t MAX_PITCHES = 32;
+const uint8_t MAX_DURATIONS = 7;
+const uint8_t ESCAPE = 0xE0;
+const uint8_t REPLAY = 0x10;
+const uint8_t MAX_REPEAT = 16;
+const uint8_t MIN_REPLAY = 3;
+const uint8_t MAX_REPLAY = 18;
+const uint8_t MAX_REPLAY_DISTANCE = 255;
+
+// Not constexpr: reaching one of these while packing stops the build
+void songUsesMoreThan32Pitches();
+void songUsesMoreThan7NoteLengths();
+
+constexpr bool isEscape(uint8_t b) {
+  return (b & ESCAPE) == ESCAPE;
+}
+
+// The players' original per-note math, now evaluated by the compiler
+constexpr CompiledNote compileNote(int16_t pitch, int16_t type, int tempo) {
+  uint16_t wholeNote = (60000 * 4) / tempo;
+  int8_t noteType = (uint16_t)type;
+  uint16_t duration = 0;
+  if (noteType > 0) {
+    duration = wholeNote / noteType;
+  } else {
+    duration = wholeNote / abs(noteType) * 1.5;
+  }
+  uint16_t toneMs = duration * 0.9;
+  return {(uint16_t)pitch, duration, toneMs};
+}
+
+// Working buffers, sized for the worst case (never more bytes than notes)
+template <uint16_t Notes>
+struct Packing {
+  uint16_t pitches[MAX_PITCHES];
+  uint16_t durationMs[MAX_DURATIONS];
+  uint16_t toneMs[MAX_DURATIONS];
+  uint8_t stream[Notes];
+  uint8_t pitchCount;
+  uint8_t durationCount;
+  uint16_t streamLength;
+};
+
+template <uint16_t Notes>
+constexpr Packing<Notes> pack(const int16_t* melody, int tempo) {
+  Packing<Notes> p = {};
+
+  // Pass 1: palettes and one symbol per note
+  uint8_t symbols[Notes] = {};
+  for (uint16_t i = 0; i < Notes; i++) {
+    CompiledNote note = compileNote(melody[i * 2], melody[i * 2 + 1], tempo);
+
+    uint8_t pitch = 0;
+    while (pitch < p.pitchCount && p.pitches[pitch] != note.frequency) pitch++;
+    if (pitch == p.pitchCount) {
+      if (p.pitchCount == MAX_PITCHES) songUsesMoreThan32Pitches();
+      p.pitches[p.pitchCount++] = note.frequency;
+    }
+
+    uint8_t duration = 0;
+    while (duration < p.durationCount && p.durationMs[duration] != note.durationMs) duration++;
+    if (duration == p.durationCount) {
+      if (p.durationCount == MAX_DURATIONS) songUsesMoreThan7NoteLengths();
+      p.durationMs[p.durationCount] = note.durationMs;
+      p.toneMs[p.durationCount++] = note.toneMs;
+    }
+
+    symbols[i] = (duration << 5) | pitch;
+  }
+
+  // Pass 2: notes and repeat escapes
+  uint8_t plain[Notes] = {};
+  uint16_t plainLength = 0;
+  for (uint16_t i = 0; i < Notes; ) {
+    plain[plainLength++] = symbols[i];
+    uint16_t run = 1;
+    while (i + run < Notes && symbols[i + run] == symbols[i]) run++;
+    i += run;
+    for (run--; run > 0; ) {
+      uint8_t n = run > MAX_REPEAT ? MAX_REPEAT : run;
+      plain[plainLength++] = ESCAPE | (n - 1);
+      run -= n;
+    }
+  }
+
+  // Pass 3: replace repeated phrases with replays of earlier stream bytes.
+  // outAt[k] is where plain byte k landed in the stream, or -1 if it was
+  // covered by a replay (those bytes can't be replayed again).
+  int16_t outAt[Notes] = {};
+  for (uint16_t j = 0; j < plainLength; ) {
+    uint16_t bestLength = 0;
+    uint16_t bestStart = 0;
+
+    // A replay can't start on a repeat escape: it repeats whatever came before
+    for (uint16_t s = 0; s < j && !isEscape(plain[j]); s++) {
+      if (outAt[s] < 0 || p.streamLength - outAt[s] > MAX_REPLAY_DISTANCE) continue;
+      uint16_t length = 0;
+      while (length < MAX_REPLAY && s + length < j && j + length < plainLength &&
+             plain[s + length] == plain[j + length] &&
+             outAt[s + length] == outAt[s] + length) {
+        length++;
+      }
+      if (length > bestLength) {
+        bestLength = length;
+        bestStart = s;
+      }
+    }
+
+    if (bestLength >= MIN_REPLAY) {
+      p.stream[p.streamLength] = ESCAPE | REPLAY | (bestLength - MIN_REPLAY);
+      p.stream[p.streamLength + 1] = p.streamLength - outAt[bestStart];
+      p.streamLength += 2;
+      for (uint16_t k = 0; k < bestLength; k++) outAt[j + k] = -1;
+      j += bestLength;
+    } else {
+      outAt[j] = p.streamLength;
+      p.stream[p.streamLength++] = plain[j++];
+    }
+  }
+  return p;
+}
+
+// The packed tables, trimmed to their real sizes
+template <uint8_t Pitches, uint8_t Durations, uint16_t Bytes>
+struct PackedSongData {
+  uint16_t pitches[Pitches];
+  uint16_t durationMs[Durations];
+  uint16_t toneMs[Durations];
+  uint8_t stream[Bytes];
+
+  constexpr PackedSong song() const {
+    return {pitches, durationMs, toneMs, stream, Bytes};
+  }
+};
+
+template <uint8_t Pitches, uint8_t Durations, uint16_t Bytes, uint16_t Notes>
+constexpr PackedSongData<Pitches, Durations, Bytes> trim(const Packing<Notes>& p) {
+  PackedSongData<Pitches, Durations, Bytes> data = {};
+  for (uint8_t i = 0; i < Pitches; i++) data.pitches[i] = p.pitches[i];
+  for (uint8_t i = 0; i < Durations; i++) {
+    data.durationMs[i] = p.durationMs[i];
+    data.toneMs[i] = p.toneMs[i];
+  }
+  for (uint16_t i = 0; i < Bytes; i++) data.stream[i] = p.stream[i];
+  return data;
+}
+
+template <const auto& melody>
+constexpr uint16_t noteCount = sizeof(melody) / sizeof(melody[0]) / 2;
+
+template <const auto& melody, int tempo>
+constexpr auto packing = pack<noteCount<melody>>(melody, tempo);
+
+} // namespace songpack
+
+// One packed song per (melody, tempo); it ends up in flash next to the code
+template <const auto& melody, int tempo>
+constexpr auto packedSong = songpack::trim<songpack::packing<melody, tempo>.pitchCount,
+                                           songpack::packing<melody, tempo>.durationCount,
+                                           songpack::packing<melody, tempo>.streamLength>(
+                                             songpack::packing<melody, tempo>);
+
+// Streams the notes of a packed song, one at a time
+class SongDecoder {
+public:
+  void begin(const PackedSong& song) {
+    song_ = song;
+    pos_ = 0;
+    replayPos_ = 0;
+    replayLeft_ = 0;
+    repeatLeft_ = 0;
+  }
+
+  // Fills 'note' and returns true, or returns false after the last note
+  bool next(CompiledNote& note) {
+    if (repeatLeft_ > 0) {
+      repeatLeft_--;
+      note = last_;
+      return true;
+    }
+
+    for (;;) {
+      uint8_t b;
+      if (replayLeft_ > 0) {
+        b = song_.stream[replayPos_++];
+        replayLeft_--;
+      } else {
+        if (pos_ >= song_.streamLength) return false;
+        b = song_.stream[pos_++];
+        if (songpack::isEscape(b) && (b & songpack::REPLAY)) {
+          replayPos_ = pos_ - 1 - song_.stream[pos_];
+          replayLeft_ = (b & 0x0F) + songpack::MIN_REPLAY;
+          pos_++;
+          continue;
+        }
+      }
+
+      if (songpack::isEscape(b)) {
+        repeatLeft_ = b & 0x0F;
+      } else {
+        last_.frequency = song_.pitches[b & 0x1F];
+        last_.durationMs = song_.durationMs[b >> 5];
+        last_.toneMs = song_.toneMs[b >> 5];
+      }
+      note = last_;
+      return true;
+    }
+  }
+
+private:
+  PackedSong song_;
+  uint16_t pos_;
+  uint16_t replayPos_;
+  uint8_t replayLeft_;
+  uint8_t repeatLeft_;
+  CompiledNote last_;
+};
+
+#endif // SONG_COMPILER_H
@@ -4,7 +4,7 @@
 #define BUZZERPIN 10
 
 // Function declarations
-void playMusic(const int16_t melody[], uint16_t numNotes, uint16_t songTempo);
+void playMusic(const PackedSong& notes);
 void playSong(ChristmasSong song);
 void playRandomSong();
 
@@ -37,7 +37,7 @@ void loop() {
     Serial.print("Now playing: ");
     Serial.println(currentSong.name);
     
-    playMusic(currentSong.melody, currentSong.size, currentSong.baseTempo);
+    playMusic(currentSong.notes);
     
     // Move to next song
     currentSongIndex++;
@@ -50,21 +50,15 @@ void loop() {
   }
 }
 
-void playMusic(const int16_t melody[], uint16_t numNotes, uint16_t songTempo) {
-  uint16_t wholeNote = (60000 * 4) / songTempo;
-  uint16_t noteDuration;
-  int8_t noteType;
+// Notes are unpacked one at a time, lengths were computed at build time (song_compiler.h)
+void playMusic(const PackedSong& notes) {
+  SongDecoder decoder;
+  CompiledNote note;
   
-  for (uint16_t i = 0; i < numNotes * 2; i += 2) {
-    noteType = pgm_read_word(&melody[i + 1]);
-    if (noteType > 0) {
-      noteDuration = wholeNote / noteType;
-    }
-    else {
-      noteDuration = wholeNote / abs(noteType) * 1.5;
-    }
-    tone(BUZZERPIN, pgm_read_word(&melody[i]), noteDuration * 0.9);
-    delay(noteDuration);
+  decoder.begin(notes);
+  while (decoder.next(note)) {
+    tone(BUZZERPIN, note.frequency, note.toneMs);
+    delay(note.durationMs);
     noTone(BUZZERPIN);
   }
 }
@@ -73,7 +67,7 @@ void playSong(ChristmasSong song) {
   Song songData = getSongData(song);
   Serial.print("Playing: ");
   Serial.println(songData.name);
-  playMusic(songData.melody, songData.size, songData.baseTempo);
+  playMusic(songData.notes);
 }
 
 void playRandomSong() {
@@ -81,7 +75,7 @@ void playRandomSong() {
   Song randomSong = getSongByIndex(randomIndex);
   Serial.print("Random song: ");
   Serial.println(randomSong.name);
-  playMusic(randomSong.melody, randomSong.size, randomSong.baseTempo);
+  playMusic(randomSong.notes);
 }
 
 // Alternative loop for playing specific songs